@@ -0,0 +1,52 @@
+//
+// Created by sabrina on 10/17/26.
+//
+// Measures how command buffer recording scales with the number of recording threads. Each run renders headless
+// frames of a large procedural scene, a grid of copies of the model, with 1, 2, 4, ... recording threads and finally
+// one per core. Meshlet culling and levels of detail are off, so the per-frame CPU work left is mostly recording.
+// Usage: command_recording_benchmark [objects] [frames]
+//
+
+#include <string>
+#include <vector>
+
+#include "../core/game.hpp"
+#include "../graphics/renderer.hpp"
+#include "../logger/logger.hpp"
+#include "../util/thread-pool.hpp"
+
+int main(int argc, char** argv) {
+	uint32_t objects = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 20000u;
+	uint64_t frames = argc > 2 ? std::stoull(argv[2]) : 500u;
+	Logger::log("Scene: ", objects, " objects, ", frames, " frames per run");
+
+	// Powers of two, then the core count even when it is not one
+	auto maxThreads = Util::ThreadPool::defaultThreadCount();
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	float serialTime = 0.0f;
+	for (auto threads : threadCounts) {
+		Graphics::RendererSettings settings{};
+		settings.headless = true;
+		settings.mesh.meshlets = false;
+		settings.mesh.lodCount = 1u;
+		settings.frameLimit = frames;
+		settings.objectCount = objects;
+		settings.recordingThreads = static_cast<uint32_t>(threads);
+
+		Core::Game game{"Command Recording Benchmark", 0, 1, 0};
+		Graphics::Renderer renderer(game, settings);
+		renderer.start();
+
+		float time = renderer.averageRecordingMilliseconds();
+		if (threads == 1u) {
+			serialTime = time;
+		}
+		Logger::log("Recording, ", threads, " threads: ", time, "ms per frame (", serialTime / time, "x)");
+	}
+	return 0;
+}
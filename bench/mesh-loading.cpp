@@ -0,0 +1,92 @@
+//
+// Created by sabrina on 10/17/26.
+//
+// Compares the tinyobj loader against the parallel ObjLoader on a procedural grid model.
+// Usage: mesh_loading_benchmark [quads per side] [obj path]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../graphics/mesh.hpp"
+#include "../graphics/obj-loader.hpp"
+#include "../logger/logger.hpp"
+
+namespace {
+	// Writes a (side + 1)^2 vertex grid with 2 * side^2 triangles, texture coordinates shared per vertex
+	void writeGrid(std::string const& path, int side) {
+		std::ofstream obj(path);
+		obj << "o grid\n";
+		for (int y = 0; y <= side; ++y) {
+			for (int x = 0; x <= side; ++x) {
+				obj << "v " << x * 0.01f << ' ' << y * 0.01f << ' ' << ((x * 7 + y * 13) % 17) * 0.001f << '\n';
+			}
+		}
+		for (int y = 0; y <= side; ++y) {
+			for (int x = 0; x <= side; ++x) {
+				obj << "vt " << static_cast<float>(x) / side << ' ' << static_cast<float>(y) / side << '\n';
+			}
+		}
+		for (int y = 0; y < side; ++y) {
+			for (int x = 0; x < side; ++x) {
+				int a = y * (side + 1) + x + 1;
+				int b = a + 1;
+				int c = a + side + 1;
+				int d = c + 1;
+				obj << "f " << a << '/' << a << ' ' << b << '/' << b << ' ' << d << '/' << d << '\n';
+				obj << "f " << a << '/' << a << ' ' << d << '/' << d << ' ' << c << '/' << c << '\n';
+			}
+		}
+	}
+
+	template <typename Function>
+	double timeMilliseconds(Function const& function) {
+		auto start = std::chrono::high_resolution_clock::now();
+		function();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count();
+	}
+}
+
+int main(int argc, char** argv) {
+	int side = argc > 1 ? std::stoi(argv[1]) : 725;
+	std::string path = argc > 2 ? argv[2] : "benchmark-grid.obj";
+	writeGrid(path, side);
+	Logger::log("Grid model: ", 2 * side * side, " triangles");
+
+	Graphics::Mesh reference;
+	double tinyobjTime = timeMilliseconds([&]() {
+		reference = Graphics::Mesh::loadObj(path);
+	});
+	Logger::log("tinyobj + VertexWelder: ", tinyobjTime, "ms, ", reference.vertexCount(), " vertices");
+
+	// Powers of two, plus the actual core count when it is not one
+	auto maxThreads = Util::ThreadPool::defaultThreadCount();
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	for (auto threads : threadCounts) {
+		Util::ThreadPool threadPool(threads);
+		Graphics::ObjLoader loader(threadPool);
+		std::optional<Graphics::Mesh> mesh;
+		double parallelTime = timeMilliseconds([&]() {
+			mesh = loader.load(path);
+		});
+		Logger::assertTrue(mesh.has_value(), "Parallel loader rejected the benchmark model");
+
+		bool identical = mesh->vertexCount() == reference.vertexCount() &&
+			mesh->indexCount() == reference.indexCount() &&
+			memcmp(mesh->vertexData(), reference.vertexData(), reference.vertexDataSize()) == 0 &&
+			memcmp(mesh->indexData(), reference.indexData(), reference.indexDataSize()) == 0;
+		Logger::log("ObjLoader, ", threads, " threads: ", parallelTime, "ms (", tinyobjTime / parallelTime,
+			"x), output ", identical ? "identical" : "DIFFERENT");
+	}
+	return 0;
+}
@@ -7,4 +7,5 @@ then
     mkdir -p build/shaders
 fi
 glslangValidator -V graphics/shaders/shader.vert -o build/shaders/vertex.spv
+glslangValidator -V graphics/shaders/shader-packed.vert -o build/shaders/packed-vertex.spv
 glslangValidator -V graphics/shaders/shader.frag -o build/shaders/fragment.spv
\ No newline at end of file
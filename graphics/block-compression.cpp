@@ -0,0 +1,402 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#include "block-compression.hpp"
+
+namespace Graphics {
+	namespace {
+		size_t const blockTexels = 16u;
+		int const refinements = 2;
+
+		using Points = float[16][4];
+
+		void loadPoints(uint8_t const* texels, size_t channelCount, Points& points) {
+			for (size_t i = 0; i < blockTexels; ++i) {
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					points[i][channel] = channel < channelCount ? static_cast<float>(texels[4u * i + channel]) : 0.0f;
+				}
+			}
+		}
+
+		// Mean and unit principal axis of the points by power iteration, the axis is zero for flat blocks
+		void principalAxis(Points const& points, float (&mean)[4], float (&axis)[4]) {
+			for (size_t channel = 0; channel < 4u; ++channel) {
+				mean[channel] = 0.0f;
+				for (size_t i = 0; i < blockTexels; ++i) {
+					mean[channel] += points[i][channel];
+				}
+				mean[channel] /= static_cast<float>(blockTexels);
+			}
+
+			float covariance[4][4] = {};
+			for (size_t i = 0; i < blockTexels; ++i) {
+				float offset[4];
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					offset[channel] = points[i][channel] - mean[channel];
+				}
+				for (size_t row = 0; row < 4u; ++row) {
+					for (size_t column = 0; column < 4u; ++column) {
+						covariance[row][column] += offset[row] * offset[column];
+					}
+				}
+			}
+
+			// Start from the row of the largest variance, it can not be orthogonal to the principal axis
+			size_t start = 0;
+			for (size_t channel = 1; channel < 4u; ++channel) {
+				if (covariance[channel][channel] > covariance[start][start]) {
+					start = channel;
+				}
+			}
+			std::copy(std::begin(covariance[start]), std::end(covariance[start]), std::begin(axis));
+			for (int iteration = 0; iteration < 8; ++iteration) {
+				float next[4] = {};
+				float largest = 0.0f;
+				for (size_t row = 0; row < 4u; ++row) {
+					for (size_t column = 0; column < 4u; ++column) {
+						next[row] += covariance[row][column] * axis[column];
+					}
+					largest = std::max(largest, std::abs(next[row]));
+				}
+				if (largest == 0.0f) {
+					break;
+				}
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					axis[channel] = next[channel] / largest;
+				}
+			}
+
+			float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+			for (float& component : axis) {
+				component = length > 1e-6f ? component / length : 0.0f;
+			}
+		}
+
+		// Endpoints at the extremes of the points projected onto the principal axis
+		void initialEndpoints(Points const& points, float (&endpoint0)[4], float (&endpoint1)[4]) {
+			float mean[4], axis[4];
+			principalAxis(points, mean, axis);
+			float low = 0.0f;
+			float high = 0.0f;
+			for (size_t i = 0; i < blockTexels; ++i) {
+				float projection = 0.0f;
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					projection += (points[i][channel] - mean[channel]) * axis[channel];
+				}
+				low = std::min(low, projection);
+				high = std::max(high, projection);
+			}
+			for (size_t channel = 0; channel < 4u; ++channel) {
+				endpoint0[channel] = mean[channel] + axis[channel] * low;
+				endpoint1[channel] = mean[channel] + axis[channel] * high;
+			}
+		}
+
+		/*
+		 * Least squares endpoints for fixed indices, where weights[index] is the interpolation factor towards
+		 * endpoint1. Returns false when all texels use the same weight and the system is singular.
+		 */
+		bool refineEndpoints(Points const& points, uint8_t const (&indices)[16], float const* weights,
+							 float (&endpoint0)[4], float (&endpoint1)[4]) {
+			float a = 0.0f, b = 0.0f, c = 0.0f;
+			float sum0[4] = {}, sum1[4] = {};
+			for (size_t i = 0; i < blockTexels; ++i) {
+				float t = weights[indices[i]];
+				float s = 1.0f - t;
+				a += s * s;
+				b += s * t;
+				c += t * t;
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					sum0[channel] += s * points[i][channel];
+					sum1[channel] += t * points[i][channel];
+				}
+			}
+
+			float determinant = a * c - b * b;
+			if (std::abs(determinant) < 1e-6f) {
+				return false;
+			}
+			for (size_t channel = 0; channel < 4u; ++channel) {
+				endpoint0[channel] = (c * sum0[channel] - b * sum1[channel]) / determinant;
+				endpoint1[channel] = (a * sum1[channel] - b * sum0[channel]) / determinant;
+			}
+			return true;
+		}
+
+		float clampByte(float value) {
+			return std::min(std::max(value, 0.0f), 255.0f);
+		}
+
+		uint16_t toRgb565(float const (&color)[4]) {
+			auto quantize = [](float value, float levels) {
+				return static_cast<uint32_t>(clampByte(value) * levels / 255.0f + 0.5f);
+			};
+			return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11u | quantize(color[1], 63.0f) << 5u |
+				quantize(color[2], 31.0f));
+		}
+
+		void fromRgb565(uint16_t color, float* out) {
+			uint32_t red = color >> 11u;
+			uint32_t green = (color >> 5u) & 63u;
+			uint32_t blue = color & 31u;
+			out[0] = static_cast<float>(red << 3u | red >> 2u);
+			out[1] = static_cast<float>(green << 2u | green >> 4u);
+			out[2] = static_cast<float>(blue << 3u | blue >> 2u);
+		}
+
+		// Picks the nearest of the colors from endpoint0 to endpoint1 for every texel, returns the squared error
+		float fitColorIndices(Points const& points, uint16_t endpoint0, uint16_t endpoint1, uint8_t (&indices)[16]) {
+			float palette[4][3];
+			fromRgb565(endpoint0, palette[0]);
+			fromRgb565(endpoint1, palette[3]);
+			for (size_t channel = 0; channel < 3u; ++channel) {
+				palette[1][channel] = (2.0f * palette[0][channel] + palette[3][channel]) / 3.0f;
+				palette[2][channel] = (palette[0][channel] + 2.0f * palette[3][channel]) / 3.0f;
+			}
+
+			float error = 0.0f;
+			for (size_t i = 0; i < blockTexels; ++i) {
+				float bestDistance = std::numeric_limits<float>::max();
+				for (uint8_t entry = 0; entry < 4u; ++entry) {
+					float distance = 0.0f;
+					for (size_t channel = 0; channel < 3u; ++channel) {
+						float difference = points[i][channel] - palette[entry][channel];
+						distance += difference * difference;
+					}
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						indices[i] = entry;
+					}
+				}
+				error += bestDistance;
+			}
+			return error;
+		}
+
+		void writeColorBlock(uint16_t endpoint0, uint16_t endpoint1, uint8_t const (&indices)[16], uint8_t* block) {
+			// Indices above run from endpoint0 to endpoint1, BC1 codes the two interpolated colors last
+			static uint8_t const codes[4] = {0u, 2u, 3u, 1u};
+			uint32_t bits = 0;
+			if (endpoint0 != endpoint1) {
+				// Four color mode needs endpoint0 > endpoint1
+				bool swap = endpoint0 < endpoint1;
+				for (size_t i = 0; i < blockTexels; ++i) {
+					uint32_t code = codes[indices[i]] ^ (swap ? 1u : 0u);
+					bits |= code << (2u * i);
+				}
+				if (swap) {
+					std::swap(endpoint0, endpoint1);
+				}
+			}
+			block[0] = static_cast<uint8_t>(endpoint0);
+			block[1] = static_cast<uint8_t>(endpoint0 >> 8u);
+			block[2] = static_cast<uint8_t>(endpoint1);
+			block[3] = static_cast<uint8_t>(endpoint1 >> 8u);
+			for (size_t byte = 0; byte < 4u; ++byte) {
+				block[4u + byte] = static_cast<uint8_t>(bits >> (8u * byte));
+			}
+		}
+
+		void encodeAlphaBlock(uint8_t const* texels, uint8_t* block) {
+			uint8_t low = 255u;
+			uint8_t high = 0u;
+			for (size_t i = 0; i < blockTexels; ++i) {
+				low = std::min(low, texels[4u * i + 3u]);
+				high = std::max(high, texels[4u * i + 3u]);
+			}
+
+			// Eight value mode (alpha0 > alpha1): codes 0 and 1 are the endpoints, 2 to 7 step from alpha0 to alpha1
+			uint64_t bits = 0;
+			if (high > low) {
+				for (size_t i = 0; i < blockTexels; ++i) {
+					auto step = static_cast<uint32_t>(static_cast<float>(high - texels[4u * i + 3u]) * 7.0f /
+						static_cast<float>(high - low) + 0.5f);
+					uint64_t code = step == 0u ? 0u : step == 7u ? 1u : step + 1u;
+					bits |= code << (3u * i);
+				}
+			}
+			block[0] = high;
+			block[1] = low;
+			for (size_t byte = 0; byte < 6u; ++byte) {
+				block[2u + byte] = static_cast<uint8_t>(bits >> (8u * byte));
+			}
+		}
+
+		void encodeColorBlock(uint8_t const* texels, uint8_t* block) {
+			static float const weights[4] = {0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f};
+			Points points;
+			loadPoints(texels, 3u, points);
+			float endpoint0[4], endpoint1[4];
+			initialEndpoints(points, endpoint0, endpoint1);
+
+			uint16_t best0 = toRgb565(endpoint0);
+			uint16_t best1 = toRgb565(endpoint1);
+			uint8_t bestIndices[16];
+			float bestError = fitColorIndices(points, best0, best1, bestIndices);
+			for (int iteration = 0; iteration < refinements && bestError > 0.0f; ++iteration) {
+				if (!refineEndpoints(points, bestIndices, weights, endpoint0, endpoint1)) {
+					break;
+				}
+				uint16_t candidate0 = toRgb565(endpoint0);
+				uint16_t candidate1 = toRgb565(endpoint1);
+				uint8_t indices[16];
+				float error = fitColorIndices(points, candidate0, candidate1, indices);
+				if (error >= bestError) {
+					break;
+				}
+				bestError = error;
+				best0 = candidate0;
+				best1 = candidate1;
+				std::copy(std::begin(indices), std::end(indices), std::begin(bestIndices));
+			}
+			writeColorBlock(best0, best1, bestIndices, block);
+		}
+
+		int const bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		struct Bc7Endpoint {
+			// Full 8 bit values, the low bit of every channel is the shared p-bit
+			uint8_t channels[4];
+		};
+
+		Bc7Endpoint quantizeBc7Endpoint(float const (&endpoint)[4]) {
+			Bc7Endpoint best{};
+			float bestError = std::numeric_limits<float>::max();
+			for (uint32_t pBit = 0; pBit < 2u; ++pBit) {
+				Bc7Endpoint candidate{};
+				float error = 0.0f;
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					float value = clampByte(endpoint[channel]);
+					auto high = static_cast<uint32_t>(std::min(std::max((value - static_cast<float>(pBit)) * 0.5f + 0.5f, 0.0f), 127.0f));
+					candidate.channels[channel] = static_cast<uint8_t>(high << 1u | pBit);
+					float difference = value - static_cast<float>(candidate.channels[channel]);
+					error += difference * difference;
+				}
+				if (error < bestError) {
+					bestError = error;
+					best = candidate;
+				}
+			}
+			return best;
+		}
+
+		float fitBc7Indices(Points const& points, Bc7Endpoint const& endpoint0, Bc7Endpoint const& endpoint1,
+							uint8_t (&indices)[16]) {
+			float palette[16][4];
+			for (size_t entry = 0; entry < 16u; ++entry) {
+				for (size_t channel = 0; channel < 4u; ++channel) {
+					palette[entry][channel] = static_cast<float>(((64 - bc7Weights[entry]) * endpoint0.channels[channel] +
+						bc7Weights[entry] * endpoint1.channels[channel] + 32) >> 6);
+				}
+			}
+
+			float error = 0.0f;
+			for (size_t i = 0; i < blockTexels; ++i) {
+				float bestDistance = std::numeric_limits<float>::max();
+				for (uint8_t entry = 0; entry < 16u; ++entry) {
+					float distance = 0.0f;
+					for (size_t channel = 0; channel < 4u; ++channel) {
+						float difference = points[i][channel] - palette[entry][channel];
+						distance += difference * difference;
+					}
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						indices[i] = entry;
+					}
+				}
+				error += bestDistance;
+			}
+			return error;
+		}
+
+		class BitWriter {
+		public:
+			explicit BitWriter(uint8_t* bytes): bytes(bytes) {}
+
+			void write(uint32_t value, uint32_t count) {
+				for (uint32_t bit = 0; bit < count; ++bit, ++position) {
+					if ((value >> bit) & 1u) {
+						bytes[position >> 3u] |= static_cast<uint8_t>(1u << (position & 7u));
+					}
+				}
+			}
+		private:
+			uint8_t* bytes;
+			uint32_t position = 0;
+		};
+
+		void writeBc7Mode6Block(Bc7Endpoint endpoint0, Bc7Endpoint endpoint1, uint8_t (&indices)[16], uint8_t* block) {
+			// The first index is stored without its high bit, so it has to point into the lower half
+			if (indices[0] & 8u) {
+				std::swap(endpoint0, endpoint1);
+				for (auto& index : indices) {
+					index = static_cast<uint8_t>(15u - index);
+				}
+			}
+
+			memset(block, 0, 16u);
+			BitWriter writer(block);
+			writer.write(1u << 6u, 7u);
+			for (size_t channel = 0; channel < 4u; ++channel) {
+				writer.write(endpoint0.channels[channel] >> 1u, 7u);
+				writer.write(endpoint1.channels[channel] >> 1u, 7u);
+			}
+			writer.write(endpoint0.channels[0] & 1u, 1u);
+			writer.write(endpoint1.channels[0] & 1u, 1u);
+			writer.write(indices[0], 3u);
+			for (size_t i = 1; i < blockTexels; ++i) {
+				writer.write(indices[i], 4u);
+			}
+		}
+	}
+
+	void encodeBc1Block(uint8_t const* texels, uint8_t* block) {
+		encodeColorBlock(texels, block);
+	}
+
+	void encodeBc3Block(uint8_t const* texels, uint8_t* block) {
+		encodeAlphaBlock(texels, block);
+		encodeColorBlock(texels, block + 8u);
+	}
+
+	void encodeBc7Block(uint8_t const* texels, uint8_t* block) {
+		static float const weights[16] = {
+			0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f, 21.0f / 64.0f, 26.0f / 64.0f,
+			30.0f / 64.0f, 34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f, 51.0f / 64.0f, 55.0f / 64.0f,
+			60.0f / 64.0f, 64.0f / 64.0f
+		};
+		Points points;
+		loadPoints(texels, 4u, points);
+		float endpoint0[4], endpoint1[4];
+		initialEndpoints(points, endpoint0, endpoint1);
+
+		auto best0 = quantizeBc7Endpoint(endpoint0);
+		auto best1 = quantizeBc7Endpoint(endpoint1);
+		uint8_t bestIndices[16];
+		float bestError = fitBc7Indices(points, best0, best1, bestIndices);
+		for (int iteration = 0; iteration < refinements && bestError > 0.0f; ++iteration) {
+			if (!refineEndpoints(points, bestIndices, weights, endpoint0, endpoint1)) {
+				break;
+			}
+			auto candidate0 = quantizeBc7Endpoint(endpoint0);
+			auto candidate1 = quantizeBc7Endpoint(endpoint1);
+			uint8_t indices[16];
+			float error = fitBc7Indices(points, candidate0, candidate1, indices);
+			if (error >= bestError) {
+				break;
+			}
+			bestError = error;
+			best0 = candidate0;
+			best1 = candidate1;
+			std::copy(std::begin(indices), std::end(indices), std::begin(bestIndices));
+		}
+		writeBc7Mode6Block(best0, best1, bestIndices, block);
+	}
+}
@@ -0,0 +1,25 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_BLOCK_COMPRESSION_HPP
+#define VULKAN_ENGINE_BLOCK_COMPRESSION_HPP
+
+#include <cstdint>
+
+namespace Graphics {
+	/*
+	 * Block encoders for one 4x4 block of RGBA8 texels in row-major order. Endpoints are fit along the
+	 * principal axis of the block and refined by least squares against the chosen indices, the error is
+	 * measured on the stored (sRGB encoded) values.
+	 */
+
+	// BC1 without alpha, 8 bytes, always in four color mode
+	void encodeBc1Block(uint8_t const* texels, uint8_t* block);
+	// BC3: a BC4 style alpha block followed by a BC1 color block, 16 bytes
+	void encodeBc3Block(uint8_t const* texels, uint8_t* block);
+	// BC7 in mode 6 (one subset, RGBA endpoints with p-bits, 4 bit indices), 16 bytes
+	void encodeBc7Block(uint8_t const* texels, uint8_t* block);
+}
+
+#endif //VULKAN_ENGINE_BLOCK_COMPRESSION_HPP
@@ -0,0 +1,62 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+
+#include "command-recorder.hpp"
+
+namespace Graphics {
+	CommandRecorder::CommandRecorder(Device& device, Util::ThreadPool& threadPool, uint32_t frameCount,
+									 uint32_t threadCount)
+		: device(device), threadPool(threadPool), threads(std::max(threadCount, 1u)) {
+		commandPools.reserve(frameCount * threads);
+		commandBuffers.reserve(frameCount * threads);
+		for (uint32_t i = 0; i < frameCount * threads; ++i) {
+			commandPools.push_back(device.createCommandPool({
+				vk::CommandPoolCreateFlagBits::eTransient,
+				device.graphicsIndex()
+			}));
+			commandBuffers.push_back(device.allocateCommandBuffers({
+				commandPools.back(),
+				vk::CommandBufferLevel::eSecondary,
+				1u
+			})[0]);
+		}
+	}
+
+	std::vector<vk::CommandBuffer> const& CommandRecorder::record(uint32_t frame, vk::RenderPass renderPass,
+																  vk::Framebuffer framebuffer, size_t count,
+																  RecordFunction const& body) {
+		vk::CommandBufferInheritanceInfo inheritanceInfo{renderPass, 0u, framebuffer};
+		threadPool.parallelFor(threads, [&](size_t thread) {
+			size_t first = count * thread / threads;
+			size_t end = count * (thread + 1u) / threads;
+			if (first == end) {
+				return;
+			}
+			auto index = frame * threads + thread;
+			// The pool belongs to this slot alone, nothing else records into it concurrently
+			device.resetCommandPool(commandPools[index]);
+			auto& commandBuffer = commandBuffers[index];
+			commandBuffer.begin({
+				vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+				&inheritanceInfo
+			});
+			body(commandBuffer, first, end);
+			commandBuffer.end();
+		});
+
+		recorded.clear();
+		for (uint32_t thread = 0; thread < threads; ++thread) {
+			if (count * thread / threads != count * (thread + 1u) / threads) {
+				recorded.push_back(commandBuffers[frame * threads + thread]);
+			}
+		}
+		return recorded;
+	}
+
+	uint32_t CommandRecorder::threadCount() const {
+		return threads;
+	}
+}
@@ -0,0 +1,49 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_COMMAND_RECORDER_HPP
+#define VULKAN_ENGINE_COMMAND_RECORDER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+#include "../util/thread-pool.hpp"
+
+namespace Graphics {
+	/*
+	 * Records a range of work in parallel into secondary command buffers that continue a render pass.
+	 * Every thread slot has its own command pool per frame in flight, so slots never share a pool and a frame's
+	 * pools are only reset once that frame finished on the GPU.
+	 */
+	class CommandRecorder {
+	public:
+		CommandRecorder(Device& device, Util::ThreadPool& threadPool, uint32_t frameCount, uint32_t threadCount);
+		CommandRecorder(CommandRecorder const&) = delete;
+		CommandRecorder& operator=(CommandRecorder const&) = delete;
+
+		using RecordFunction = std::function<void(vk::CommandBuffer commandBuffer, size_t first, size_t end)>;
+
+		// Splits [0, count) into one contiguous range per thread and calls body for each range on the thread pool,
+		// recording into a secondary command buffer inheriting subpass 0 of renderPass. Returns the secondary
+		// command buffers in range order, for the primary command buffer to execute.
+		std::vector<vk::CommandBuffer> const& record(uint32_t frame, vk::RenderPass renderPass,
+													 vk::Framebuffer framebuffer, size_t count,
+													 RecordFunction const& body);
+
+		uint32_t threadCount() const;
+	private:
+		Device& device;
+		Util::ThreadPool& threadPool;
+		uint32_t threads;
+		// Indexed by frame * threads + thread, as are commandBuffers
+		std::vector<vk::CommandPool> commandPools;
+		std::vector<vk::CommandBuffer> commandBuffers;
+		std::vector<vk::CommandBuffer> recorded;
+	};
+}
+
+#endif //VULKAN_ENGINE_COMMAND_RECORDER_HPP
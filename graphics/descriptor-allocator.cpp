@@ -0,0 +1,153 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "descriptor-allocator.hpp"
+#include "../logger/logger.hpp"
+#include "../util/hash.hpp"
+
+namespace Graphics {
+	namespace {
+		// Sets of the layout that ran out each new pool has room for
+		uint32_t const setsPerPool = 64u;
+
+		bool fits(std::vector<vk::DescriptorPoolSize> const& available,
+				  std::vector<vk::DescriptorPoolSize> const& needed) {
+			return std::all_of(needed.begin(), needed.end(), [&](vk::DescriptorPoolSize const& size) {
+				return std::any_of(available.begin(), available.end(), [&](vk::DescriptorPoolSize const& other) {
+					return other.type == size.type && other.descriptorCount >= size.descriptorCount;
+				});
+			});
+		}
+
+		void take(std::vector<vk::DescriptorPoolSize>& available, std::vector<vk::DescriptorPoolSize> const& needed) {
+			for (auto const& size : needed) {
+				auto left = std::find_if(available.begin(), available.end(), [&](vk::DescriptorPoolSize const& other) {
+					return other.type == size.type;
+				});
+				left->descriptorCount -= size.descriptorCount;
+			}
+		}
+	}
+
+	// Writes are hashed byte for byte, which only works without padding between the fields
+	static_assert(sizeof(DescriptorWrite) == 4u * sizeof(uint32_t) + 5u * sizeof(uint64_t),
+		"DescriptorWrite must not contain padding");
+
+	DescriptorWrite DescriptorWrite::buffer(uint32_t binding, vk::DescriptorType type, vk::Buffer buffer,
+											vk::DeviceSize offset, vk::DeviceSize range) {
+		DescriptorWrite write{};
+		write.binding = binding;
+		write.type = type;
+		write.buffer = buffer;
+		write.offset = offset;
+		write.range = range;
+		return write;
+	}
+
+	DescriptorWrite DescriptorWrite::image(uint32_t binding, vk::DescriptorType type, vk::Sampler sampler,
+										   vk::ImageView imageView, vk::ImageLayout imageLayout) {
+		DescriptorWrite write{};
+		write.binding = binding;
+		write.type = type;
+		write.sampler = sampler;
+		write.imageView = imageView;
+		write.imageLayout = imageLayout;
+		return write;
+	}
+
+	bool DescriptorWrite::operator==(DescriptorWrite const& other) const {
+		return memcmp(this, &other, sizeof(DescriptorWrite)) == 0;
+	}
+
+	DescriptorAllocator::DescriptorAllocator(Device& device, LayoutCache& layouts, uint32_t frameCount)
+		: device(device), layouts(layouts), frames(frameCount) {}
+
+	vk::DescriptorSet DescriptorAllocator::cached(vk::DescriptorSetLayout layout,
+												  std::vector<DescriptorWrite> const& writes) {
+		VkDescriptorSetLayout layoutHandle = layout;
+		auto key = Util::hash64(writes.data(), writes.size() * sizeof(DescriptorWrite),
+			Util::hash64(&layoutHandle, sizeof(layoutHandle)));
+		auto found = cachedSets.find(key);
+		if (found != cachedSets.end()) {
+			Logger::assertTrue(found->second.layout == layout && found->second.writes == writes,
+				"Descriptor set hash collision");
+			return found->second.set;
+		}
+
+		auto set = allocate(persistent, layout);
+		write(set, writes);
+		cachedSets.emplace(key, CachedSet{layout, writes, set});
+		return set;
+	}
+
+	vk::DescriptorSet DescriptorAllocator::transient(uint32_t frame, vk::DescriptorSetLayout layout,
+													 std::vector<DescriptorWrite> const& writes) {
+		auto set = allocate(frames[frame], layout);
+		write(set, writes);
+		return set;
+	}
+
+	void DescriptorAllocator::resetFrame(uint32_t frame) {
+		for (auto& pool : frames[frame].pools) {
+			if (pool.setsLeft == setsPerPool) {
+				continue;
+			}
+			device.resetDescriptorPool(pool.pool);
+			pool.setsLeft = setsPerPool;
+			pool.descriptorsLeft = pool.capacity;
+		}
+	}
+
+	vk::DescriptorSet DescriptorAllocator::allocate(PoolList& poolList, vk::DescriptorSetLayout layout) {
+		auto const& needed = sizesOf(layout);
+		// Pools are never freed from individually, so counting is exact and the first one with room can hold the set
+		auto pool = std::find_if(poolList.pools.begin(), poolList.pools.end(), [&](Pool const& candidate) {
+			return candidate.setsLeft > 0u && fits(candidate.descriptorsLeft, needed);
+		});
+		if (pool == poolList.pools.end()) {
+			auto capacity = layouts.poolSizes(layout, setsPerPool);
+			poolList.pools.push_back({device.createDescriptorPool(setsPerPool, capacity), capacity, setsPerPool,
+				capacity});
+			pool = std::prev(poolList.pools.end());
+		}
+		--pool->setsLeft;
+		take(pool->descriptorsLeft, needed);
+		return device.allocateDescriptorSets(pool->pool, layout, 1u)[0];
+	}
+
+	std::vector<vk::DescriptorPoolSize> const& DescriptorAllocator::sizesOf(vk::DescriptorSetLayout layout) {
+		auto found = setSizes.find(layout);
+		if (found == setSizes.end()) {
+			found = setSizes.emplace(layout, layouts.poolSizes(layout, 1u)).first;
+		}
+		return found->second;
+	}
+
+	// Texel buffer descriptors are not supported
+	void DescriptorAllocator::write(vk::DescriptorSet set, std::vector<DescriptorWrite> const& writes) {
+		// Reserved up front so the pointers in descriptorWrites stay valid
+		std::vector<vk::DescriptorBufferInfo> bufferInfos;
+		std::vector<vk::DescriptorImageInfo> imageInfos;
+		bufferInfos.reserve(writes.size());
+		imageInfos.reserve(writes.size());
+
+		std::vector<vk::WriteDescriptorSet> descriptorWrites;
+		for (auto const& write : writes) {
+			vk::WriteDescriptorSet descriptorWrite{set, write.binding, write.arrayElement, 1u, write.type};
+			if (write.buffer) {
+				bufferInfos.emplace_back(write.buffer, write.offset, write.range);
+				descriptorWrite.pBufferInfo = &bufferInfos.back();
+			} else {
+				imageInfos.emplace_back(write.sampler, write.imageView, write.imageLayout);
+				descriptorWrite.pImageInfo = &imageInfos.back();
+			}
+			descriptorWrites.push_back(descriptorWrite);
+		}
+		device.updateDescriptorSets(descriptorWrites);
+	}
+}
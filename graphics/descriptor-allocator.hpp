@@ -0,0 +1,91 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_ENGINE_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+#include "layout-cache.hpp"
+
+namespace Graphics {
+	// One descriptor to write, the buffer or the image fields are left null depending on the type
+	struct DescriptorWrite {
+		uint32_t binding;
+		uint32_t arrayElement;
+		vk::DescriptorType type;
+		vk::ImageLayout imageLayout;
+		vk::Buffer buffer;
+		vk::DeviceSize offset;
+		vk::DeviceSize range;
+		vk::Sampler sampler;
+		vk::ImageView imageView;
+
+		static DescriptorWrite buffer(uint32_t binding, vk::DescriptorType type, vk::Buffer buffer,
+									  vk::DeviceSize offset, vk::DeviceSize range);
+		static DescriptorWrite image(uint32_t binding, vk::DescriptorType type, vk::Sampler sampler,
+									 vk::ImageView imageView, vk::ImageLayout imageLayout);
+		bool operator==(DescriptorWrite const& other) const;
+	};
+
+	/*
+	 * Hands out descriptor sets from lists of pools, adding a pool whenever none of them has room left, so nothing
+	 * has to know up front how many sets there will be. New pools are sized for the layout that ran out. The sets
+	 * and descriptors left in each pool are counted here rather than discovered through allocation errors, which
+	 * Vulkan 1.0 without VK_KHR_maintenance1 does not report, and any pool with room for a layout is used for it.
+	 * Long-lived sets come from shared pools and are cached by layout and contents, so identical material sets are
+	 * allocated and written once. Transient sets come from per-frame pools that are reset in bulk once the frame's
+	 * previous submission finished.
+	 */
+	class DescriptorAllocator {
+	public:
+		DescriptorAllocator(Device& device, LayoutCache& layouts, uint32_t frameCount);
+		DescriptorAllocator(DescriptorAllocator const&) = delete;
+		DescriptorAllocator& operator=(DescriptorAllocator const&) = delete;
+
+		// A set with the layout and writes, shared with earlier calls that asked for the same
+		vk::DescriptorSet cached(vk::DescriptorSetLayout layout, std::vector<DescriptorWrite> const& writes);
+		// A written set that stays valid until the frame's pools are reset
+		vk::DescriptorSet transient(uint32_t frame, vk::DescriptorSetLayout layout,
+									std::vector<DescriptorWrite> const& writes);
+		// The GPU must be done with every set allocated for the frame since its last reset
+		void resetFrame(uint32_t frame);
+	private:
+		struct Pool {
+			vk::DescriptorPool pool;
+			std::vector<vk::DescriptorPoolSize> capacity;
+			// What is still free until the pool is reset
+			uint32_t setsLeft;
+			std::vector<vk::DescriptorPoolSize> descriptorsLeft;
+		};
+
+		struct PoolList {
+			std::vector<Pool> pools;
+		};
+
+		struct CachedSet {
+			vk::DescriptorSetLayout layout;
+			std::vector<DescriptorWrite> writes;
+			vk::DescriptorSet set;
+		};
+
+		Device& device;
+		LayoutCache& layouts;
+		PoolList persistent;
+		std::vector<PoolList> frames;
+		std::unordered_map<uint64_t, CachedSet> cachedSets;
+		// Descriptors one set of each layout takes, so allocations do not go through the layout cache's lock
+		std::unordered_map<VkDescriptorSetLayout, std::vector<vk::DescriptorPoolSize>> setSizes;
+
+		vk::DescriptorSet allocate(PoolList& poolList, vk::DescriptorSetLayout layout);
+		std::vector<vk::DescriptorPoolSize> const& sizesOf(vk::DescriptorSetLayout layout);
+		void write(vk::DescriptorSet set, std::vector<DescriptorWrite> const& writes);
+	};
+}
+
+#endif //VULKAN_ENGINE_DESCRIPTOR_ALLOCATOR_HPP
@@ -2,6 +2,8 @@
 // Created by sabrina on 10/7/19.
 //
 
+#include <algorithm>
+
 #include "device.hpp"
 #include "../logger/logger.hpp"
 #include "../util/algorithm.hpp"
@@ -9,39 +11,59 @@
 
 namespace Graphics {
 	Device::Device(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR& surface,
-				   std::vector<char const*> const& deviceExtensions) : physicalDevice(physicalDevice), surface(surface) {
+				   std::vector<char const*> const& deviceExtensions, uint32_t apiVersion)
+		: physicalDevice(physicalDevice), surface(surface) {
 		queueFamilies = physicalDevice.getQueueFamilyProperties();
 		Logger::assertNotEmpty(queueFamilies, "Device supports no queue families.");
 
 		extensionProperties = physicalDevice.enumerateDeviceExtensionProperties();
 		Logger::assertNotEmpty(extensionProperties, "Device supports no extensions.");
 
+		supportedFeatures = physicalDevice.getFeatures();
 		auto properties = physicalDevice.getProperties();
+		limits = properties.limits;
+		// Vulkan 1.2 feature queries are only valid when both the instance and the device have it
+		if (std::min(apiVersion, properties.apiVersion) >= VK_API_VERSION_1_2) {
+			auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+			timelineSemaphores = features.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore;
+		}
 		msaaSamples = Util::maxSampleCount(properties.limits.framebufferColorSampleCounts & properties.limits.framebufferDepthSampleCounts);
 
 		graphicsQueueFamilyIndex = findGraphicsQueueFamilyIndex();
 		presentQueueFamilyIndex = findPresentQueueFamilyIndex();
+		transferQueueFamilyIndex = findTransferQueueFamilyIndex();
 		rating = rate(deviceExtensions);
 	}
 
 	std::vector<vk::DeviceQueueCreateInfo> Device::getDeviceQueueCreateInfos(float* queuePriorities) {
-		uint32_t presentQFIndex = Logger::unwrap(presentQueueFamilyIndex,
-			"Physical device does not have present queue.");
 		uint32_t graphicsQFIndex = Logger::unwrap(graphicsQueueFamilyIndex,
 			"Physical device does not have graphics queue.");
 		std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos{};
 
 		queueCreateInfos.emplace_back(generateDeviceQueueCreateInfo(graphicsQFIndex, queuePriorities));
 
-		if (presentQFIndex != graphicsQFIndex) {
-			queueCreateInfos.emplace_back(generateDeviceQueueCreateInfo(presentQFIndex, queuePriorities));
+		if (requiresPresentation()) {
+			uint32_t presentQFIndex = Logger::unwrap(presentQueueFamilyIndex,
+				"Physical device does not have present queue.");
+			if (presentQFIndex != graphicsQFIndex) {
+				queueCreateInfos.emplace_back(generateDeviceQueueCreateInfo(presentQFIndex, queuePriorities));
+			}
+		}
+
+		if (hasDedicatedTransferQueue() &&
+			(!requiresPresentation() || *transferQueueFamilyIndex != *presentQueueFamilyIndex)) {
+			queueCreateInfos.emplace_back(generateDeviceQueueCreateInfo(*transferQueueFamilyIndex, queuePriorities));
 		}
 
 		return queueCreateInfos;
 	}
 
 	int Device::rate(std::vector<char const*> const& deviceExtensions) {
-		if (!(presentQueueFamilyIndex.has_value() && graphicsQueueFamilyIndex.has_value())) {
+		if (!graphicsQueueFamilyIndex.has_value()) {
+			return 0;
+		}
+
+		if (requiresPresentation() && !presentQueueFamilyIndex.has_value()) {
 			return 0;
 		}
 
@@ -74,6 +96,10 @@ namespace Graphics {
 	}
 
 	std::optional<uint32_t> Device::findPresentQueueFamilyIndex() {
+		if (!requiresPresentation()) {
+			return {};
+		}
+
 		for (uint32_t i = 0; i < static_cast<uint32_t>(queueFamilies.size()); ++i) {
 			vk::QueueFamilyProperties& queueFamilyProperties = queueFamilies[i];
 			if (queueFamilyProperties.queueCount > 0 &&
@@ -84,6 +110,26 @@ namespace Graphics {
 		return {};
 	}
 
+	// Prefers pure copy engines (transfer without graphics or compute), then any transfer family without graphics
+	std::optional<uint32_t> Device::findTransferQueueFamilyIndex() {
+		std::optional<uint32_t> candidate;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(queueFamilies.size()); ++i) {
+			vk::QueueFamilyProperties& queueFamilyProperties = queueFamilies[i];
+			if (queueFamilyProperties.queueCount == 0 ||
+				!(queueFamilyProperties.queueFlags & vk::QueueFlagBits::eTransfer) ||
+				queueFamilyProperties.queueFlags & vk::QueueFlagBits::eGraphics) {
+				continue;
+			}
+			if (!(queueFamilyProperties.queueFlags & vk::QueueFlagBits::eCompute)) {
+				return i;
+			}
+			if (!candidate) {
+				candidate = i;
+			}
+		}
+		return candidate;
+	}
+
 	vk::DeviceQueueCreateInfo Device::generateDeviceQueueCreateInfo(uint32_t index, float* queuePriorities) {
 		return vk::DeviceQueueCreateInfo{
 			{},
@@ -101,8 +147,11 @@ namespace Graphics {
 		vk::PhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.samplerAnisotropy = true;
 		deviceFeatures.sampleRateShading = true;
+		deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+		vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.timelineSemaphore = timelineSemaphores;
 
-		logicalDevice = physicalDevice.createDevice({
+		vk::DeviceCreateInfo createInfo{
 			{},
 			static_cast<uint32_t>(queueCreateInfos.size()),
 			queueCreateInfos.data(),
@@ -113,15 +162,39 @@ namespace Graphics {
 			static_cast<uint32_t>(deviceExtensions.size()),
 			deviceExtensions.data(),
 			&deviceFeatures
-		});
+		};
+		if (timelineSemaphores) {
+			createInfo.pNext = &vulkan12Features;
+		}
+		logicalDevice = physicalDevice.createDevice(createInfo);
 		graphicsQueue = logicalDevice.getQueue(graphicsIndex(), 0);
-		presentQueue = logicalDevice.getQueue(presentIndex(), 0);
+		if (requiresPresentation()) {
+			presentQueue = logicalDevice.getQueue(presentIndex(), 0);
+		}
+		transferQueue = hasDedicatedTransferQueue() ? logicalDevice.getQueue(transferIndex(), 0) : graphicsQueue;
 	}
 
 	bool Device::isUsable() {
 		return rating > 0;
 	}
 
+	bool Device::supportsMultiDrawIndirect() {
+		return static_cast<bool>(supportedFeatures.multiDrawIndirect);
+	}
+
+	bool Device::supportsTimelineSemaphores() {
+		return timelineSemaphores;
+	}
+
+	// Headless renderers have no surface, so presentation support is neither queried nor required
+	bool Device::requiresPresentation() {
+		return static_cast<bool>(surface);
+	}
+
+	bool Device::hasDedicatedTransferQueue() {
+		return transferQueueFamilyIndex.has_value();
+	}
+
 	uint32_t Device::graphicsIndex() {
 		return Logger::unwrap(graphicsQueueFamilyIndex, "Device does not have graphics queue.");
 	}
@@ -130,6 +203,10 @@ namespace Graphics {
 		return Logger::unwrap(presentQueueFamilyIndex, "Device does not have present queue.");
 	}
 
+	uint32_t Device::transferIndex() {
+		return transferQueueFamilyIndex.value_or(graphicsIndex());
+	}
+
 	vk::Semaphore Device::createSemaphore(vk::SemaphoreCreateInfo const& info) {
 		return logicalDevice.createSemaphore(info);
 	}
@@ -138,6 +215,11 @@ namespace Graphics {
 		return logicalDevice.createFence(info);
 	}
 
+	vk::Semaphore Device::createTimelineSemaphore(uint64_t initialValue) {
+		vk::SemaphoreTypeCreateInfo typeInfo{vk::SemaphoreType::eTimeline, initialValue};
+		return logicalDevice.createSemaphore({{}, &typeInfo});
+	}
+
 	vk::CommandPool Device::createCommandPool(vk::CommandPoolCreateInfo const& info) {
 		return logicalDevice.createCommandPool(info);
 	}
@@ -146,6 +228,10 @@ namespace Graphics {
 		return logicalDevice.allocateCommandBuffers(info);
 	}
 
+	void Device::resetCommandPool(vk::CommandPool pool) {
+		logicalDevice.resetCommandPool(pool, {});
+	}
+
 	vk::SwapchainKHR Device::createSwapchain(vk::SwapchainCreateInfoKHR const& info) {
 		return logicalDevice.createSwapchainKHR(info);
 	}
@@ -267,8 +353,16 @@ namespace Graphics {
 		return logicalDevice.createPipelineLayout(info);
 	}
 
-	vk::Pipeline Device::createGraphicsPipeline(vk::GraphicsPipelineCreateInfo info) {
-		return logicalDevice.createGraphicsPipeline(vk::PipelineCache{}, info);
+	vk::PipelineCache Device::createPipelineCache(std::vector<uint8_t> const& initialData) {
+		return logicalDevice.createPipelineCache({{}, initialData.size(), initialData.data()});
+	}
+
+	std::vector<uint8_t> Device::getPipelineCacheData(vk::PipelineCache cache) {
+		return logicalDevice.getPipelineCacheData(cache);
+	}
+
+	vk::Pipeline Device::createGraphicsPipeline(vk::GraphicsPipelineCreateInfo info, vk::PipelineCache cache) {
+		return logicalDevice.createGraphicsPipeline(cache, info);
 	}
 
 	vk::ResultValue<uint32_t> Device::acquireNextImage(vk::SwapchainKHR swapchain, vk::Semaphore semaphore) {
@@ -283,28 +377,42 @@ namespace Graphics {
 		logicalDevice.waitForFences(1, &fence, true, UINT64_MAX);
 	}
 
+	bool Device::isFenceSignaled(vk::Fence fence) {
+		return logicalDevice.getFenceStatus(fence) == vk::Result::eSuccess;
+	}
+
+	uint64_t Device::getSemaphoreCounterValue(vk::Semaphore semaphore) {
+		return logicalDevice.getSemaphoreCounterValue(semaphore);
+	}
+
+	void Device::waitForSemaphore(vk::Semaphore semaphore, uint64_t value) {
+		logicalDevice.waitSemaphores({{}, 1u, &semaphore, &value}, UINT64_MAX);
+	}
+
 	void Device::waitUntilIdle() {
 		logicalDevice.waitIdle();
 	}
 
-	void Device::destroySwapchain(vk::SwapchainKHR swapchain, std::vector<vk::Framebuffer> framebuffers,
-								  vk::CommandPool commandPool, std::vector<vk::CommandBuffer> commandBuffers,
-								  vk::Pipeline pipeline, vk::RenderPass renderPass, std::vector<Image> images,
-								  vk::DescriptorPool descriptorPool) {
+	void Device::destroySwapchain(vk::SwapchainKHR swapchain) {
+		logicalDevice.destroySwapchainKHR(swapchain);
+	}
+
+	void Device::destroyFramebuffers(std::vector<vk::Framebuffer> const& framebuffers) {
 		for (auto framebuffer : framebuffers) {
 			logicalDevice.destroyFramebuffer(framebuffer);
 		}
-		logicalDevice.freeCommandBuffers(commandPool, commandBuffers);
-		logicalDevice.destroyPipeline(pipeline);
-		logicalDevice.destroyRenderPass(renderPass);
-		logicalDevice.destroyDescriptorPool(descriptorPool);
+	}
 
-		for (auto image : images) {
-			logicalDevice.destroyImageView(image);
-		}
-		images.clear();
+	void Device::destroyImageView(vk::ImageView view) {
+		logicalDevice.destroyImageView(view);
+	}
 
-		logicalDevice.destroySwapchainKHR(swapchain);
+	void Device::destroyShaderModule(vk::ShaderModule module) {
+		logicalDevice.destroyShaderModule(module);
+	}
+
+	void Device::destroyPipeline(vk::Pipeline pipeline) {
+		logicalDevice.destroyPipeline(pipeline);
 	}
 
 	vk::SurfaceCapabilitiesKHR Device::getCapabilities() {
@@ -328,12 +436,11 @@ namespace Graphics {
 		return logicalDevice.createDescriptorSetLayout(createInfo);
 	}
 
-	vk::DescriptorPool Device::createDescriptorPool(uint32_t size) {
-		std::vector<vk::DescriptorPoolSize> poolSizes{
-			{vk::DescriptorType::eUniformBuffer, size},
-			{vk::DescriptorType::eCombinedImageSampler, size}
-		};
-		return logicalDevice.createDescriptorPool({{}, size, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()});
+	vk::DescriptorPool Device::createDescriptorPool(uint32_t maxSets,
+													std::vector<vk::DescriptorPoolSize> const& poolSizes) {
+		return logicalDevice.createDescriptorPool({
+			{}, maxSets, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()
+		});
 	}
 
 	std::vector<vk::DescriptorSet> Device::allocateDescriptorSets(vk::DescriptorPool pool,
@@ -349,6 +456,10 @@ namespace Graphics {
 		logicalDevice.updateDescriptorSets(static_cast<uint32_t>(sets.size()), sets.data(), 0u, nullptr);
 	}
 
+	void Device::resetDescriptorPool(vk::DescriptorPool pool) {
+		logicalDevice.resetDescriptorPool(pool);
+	}
+
 	vk::Sampler Device::createSampler(vk::SamplerCreateInfo const& createInfo) {
 		return logicalDevice.createSampler(createInfo);
 	}
@@ -356,4 +467,12 @@ namespace Graphics {
 	vk::SampleCountFlagBits Device::getSamples() {
 		return msaaSamples;
 	}
+
+	vk::PhysicalDeviceProperties Device::getProperties() {
+		return physicalDevice.getProperties();
+	}
+
+	vk::DeviceSize Device::minUniformBufferOffsetAlignment() {
+		return limits.minUniformBufferOffsetAlignment;
+	}
 }
@@ -13,22 +13,36 @@ namespace Graphics {
 	class Image;
 	class Device {
 	public:
-		Device(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR& surface, std::vector<char const*> const& deviceExtensions);
+		// apiVersion is the version the instance was created with
+		Device(vk::PhysicalDevice physicalDevice, vk::SurfaceKHR& surface, std::vector<char const*> const& deviceExtensions,
+			   uint32_t apiVersion);
 
 		bool operator<(Device& other);
 		std::vector<vk::DeviceQueueCreateInfo> getDeviceQueueCreateInfos(float* queuePriorities);
 		bool isUsable();
+		bool requiresPresentation();
+		bool supportsMultiDrawIndirect();
+		// Vulkan 1.2 timeline semaphores, enabled on the logical device when supported
+		bool supportsTimelineSemaphores();
+
+		bool hasDedicatedTransferQueue();
 
 		uint32_t graphicsIndex();
 		uint32_t presentIndex();
+		// Family of transferQueue, the graphics family when there is no dedicated transfer queue
+		uint32_t transferIndex();
 
 		vk::Queue graphicsQueue;
 		vk::Queue presentQueue;
+		// Dedicated transfer-only queue if the device has one, otherwise the graphics queue
+		vk::Queue transferQueue;
 
 		vk::Semaphore createSemaphore(vk::SemaphoreCreateInfo const& info);
 		vk::Fence createFence(vk::FenceCreateInfo const& info);
+		vk::Semaphore createTimelineSemaphore(uint64_t initialValue);
 		vk::CommandPool createCommandPool(vk::CommandPoolCreateInfo const& info);
 		std::vector<vk::CommandBuffer> allocateCommandBuffers(vk::CommandBufferAllocateInfo const& info);
+		void resetCommandPool(vk::CommandPool pool);
 		vk::SwapchainKHR createSwapchain(vk::SwapchainCreateInfoKHR const& info);
 
 		std::vector<Image> getSwapchainImages(vk::SwapchainKHR const& swapchain, vk::Format const& format);
@@ -53,43 +67,58 @@ namespace Graphics {
 		vk::MemoryRequirements getImageMemoryRequirements(vk::Image image);
 		vk::ShaderModule createShaderModule(std::vector<char> code);
 		vk::PipelineLayout createPipelineLayout(vk::PipelineLayoutCreateInfo info);
-		vk::Pipeline createGraphicsPipeline(vk::GraphicsPipelineCreateInfo info);
+		vk::PipelineCache createPipelineCache(std::vector<uint8_t> const& initialData);
+		std::vector<uint8_t> getPipelineCacheData(vk::PipelineCache cache);
+		vk::Pipeline createGraphicsPipeline(vk::GraphicsPipelineCreateInfo info, vk::PipelineCache cache);
 		vk::ResultValue<uint32_t> acquireNextImage(vk::SwapchainKHR swapchain, vk::Semaphore semaphore);
 		void resetFence(vk::Fence fence);
 		void waitForFence(vk::Fence& fence);
+		bool isFenceSignaled(vk::Fence fence);
+		uint64_t getSemaphoreCounterValue(vk::Semaphore semaphore);
+		void waitForSemaphore(vk::Semaphore semaphore, uint64_t value);
 		void waitUntilIdle();
 		void printDescription();
-		void destroySwapchain(vk::SwapchainKHR swapchain, std::vector<vk::Framebuffer> framebuffers,
-							  vk::CommandPool commandPool, std::vector<vk::CommandBuffer> commandBuffers,
-							  vk::Pipeline pipeline, vk::RenderPass renderPass, std::vector<Image> images,
-							  vk::DescriptorPool descriptorPool);
+		void destroySwapchain(vk::SwapchainKHR swapchain);
+		void destroyFramebuffers(std::vector<vk::Framebuffer> const& framebuffers);
+		void destroyImageView(vk::ImageView view);
+		void destroyShaderModule(vk::ShaderModule module);
+		void destroyPipeline(vk::Pipeline pipeline);
 		vk::SurfaceCapabilitiesKHR getCapabilities();
 		std::vector<vk::SurfaceFormatKHR> getSurfaceFormats();
 		std::vector<vk::PresentModeKHR> getPresentModes();
 		vk::DescriptorSetLayout createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo const& createInfo);
-		vk::DescriptorPool createDescriptorPool(uint32_t size);
+		vk::DescriptorPool createDescriptorPool(uint32_t maxSets,
+												std::vector<vk::DescriptorPoolSize> const& poolSizes);
 		std::vector<vk::DescriptorSet> allocateDescriptorSets(vk::DescriptorPool pool, vk::DescriptorSetLayout layout,
 															  vk::DeviceSize size);
 		void updateDescriptorSets(std::vector<vk::WriteDescriptorSet> sets);
+		void resetDescriptorPool(vk::DescriptorPool pool);
 		vk::Sampler createSampler(vk::SamplerCreateInfo const& createInfo);
 		vk::SampleCountFlagBits getSamples();
+		vk::PhysicalDeviceProperties getProperties();
+		vk::DeviceSize minUniformBufferOffsetAlignment();
 	private:
 		vk::PhysicalDevice physicalDevice;
 		vk::Device logicalDevice;
 		vk::SurfaceKHR& surface;
 		vk::SampleCountFlagBits msaaSamples;
+		vk::PhysicalDeviceFeatures supportedFeatures;
+		bool timelineSemaphores = false;
+		vk::PhysicalDeviceLimits limits;
 
 		std::vector<vk::QueueFamilyProperties> queueFamilies;
 		std::vector<vk::ExtensionProperties> extensionProperties;
 
 		std::optional<uint32_t> graphicsQueueFamilyIndex;
 		std::optional<uint32_t> presentQueueFamilyIndex;
+		std::optional<uint32_t> transferQueueFamilyIndex;
 
 		int rating;
 		int rate(std::vector<char const*> const& deviceExtensions);
 
 		std::optional<uint32_t> findGraphicsQueueFamilyIndex();
 		std::optional<uint32_t> findPresentQueueFamilyIndex();
+		std::optional<uint32_t> findTransferQueueFamilyIndex();
 
 		static vk::DeviceQueueCreateInfo generateDeviceQueueCreateInfo(uint32_t index, float* queuePriorities);
 	};
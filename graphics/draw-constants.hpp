@@ -0,0 +1,21 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_DRAW_CONSTANTS_HPP
+#define VULKAN_ENGINE_DRAW_CONSTANTS_HPP
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Graphics {
+	// Per-draw data pushed with the draw, must stay within the 128 bytes every device supports
+	struct DrawConstants {
+		glm::mat4 model;
+		uint32_t objectId;
+	};
+
+	static_assert(sizeof(DrawConstants) <= 128u, "Draw constants exceed the guaranteed push constant size");
+}
+
+#endif //VULKAN_ENGINE_DRAW_CONSTANTS_HPP
@@ -0,0 +1,119 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+
+#include "frame-timeline.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	FrameTimeline::FrameTimeline(Device& device)
+		: device(device), timelineSemaphore(device.supportsTimelineSemaphores()) {
+		if (timelineSemaphore) {
+			semaphore = device.createTimelineSemaphore(0u);
+		}
+	}
+
+	uint64_t FrameTimeline::submit(vk::SubmitInfo submitInfo) {
+		auto point = ++submitted;
+		if (!timelineSemaphore) {
+			vk::Fence fence;
+			if (freeFences.empty()) {
+				fence = device.createFence({});
+			} else {
+				fence = freeFences.back();
+				freeFences.pop_back();
+				device.resetFence(fence);
+			}
+			device.graphicsQueue.submit(1u, &submitInfo, fence);
+			pendingFences.push_back({point, fence});
+			return point;
+		}
+
+		// Binary semaphores the caller signals come first, their values are ignored
+		std::vector<vk::Semaphore> signalSemaphores(submitInfo.pSignalSemaphores,
+			submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
+		signalSemaphores.push_back(semaphore);
+		std::vector<uint64_t> signalValues(signalSemaphores.size(), 0u);
+		signalValues.back() = point;
+		vk::TimelineSemaphoreSubmitInfo timelineInfo{
+			0u, nullptr, static_cast<uint32_t>(signalValues.size()), signalValues.data()
+		};
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
+		timelineInfo.pNext = submitInfo.pNext;
+		submitInfo.pNext = &timelineInfo;
+		device.graphicsQueue.submit(1u, &submitInfo, vk::Fence{});
+		return point;
+	}
+
+	uint64_t FrameTimeline::lastSubmitted() const {
+		return submitted;
+	}
+
+	uint64_t FrameTimeline::completed() {
+		if (timelineSemaphore) {
+			completedPoint = device.getSemaphoreCounterValue(semaphore);
+			return completedPoint;
+		}
+		// A signaled fence implies every earlier submission finished too
+		for (auto pending = pendingFences.rbegin(); pending != pendingFences.rend(); ++pending) {
+			if (device.isFenceSignaled(pending->fence)) {
+				retireFencesUpTo(pending->point);
+				break;
+			}
+		}
+		return completedPoint;
+	}
+
+	bool FrameTimeline::isComplete(uint64_t point) {
+		return point <= completedPoint || point <= completed();
+	}
+
+	void FrameTimeline::wait(uint64_t point) {
+		if (isComplete(point)) {
+			return;
+		}
+		Logger::assertTrue(point <= submitted, "Waiting for a point that was never submitted");
+		if (timelineSemaphore) {
+			device.waitForSemaphore(semaphore, point);
+			completedPoint = std::max(completedPoint, point);
+		} else {
+			for (auto const& pending : pendingFences) {
+				if (pending.point >= point) {
+					auto fence = pending.fence;
+					auto signaledPoint = pending.point;
+					device.waitForFence(fence);
+					retireFencesUpTo(signaledPoint);
+					break;
+				}
+			}
+		}
+		collect();
+	}
+
+	void FrameTimeline::release(std::function<void()> release) {
+		pendingReleases.push_back({submitted, std::move(release)});
+	}
+
+	void FrameTimeline::collect() {
+		if (pendingReleases.empty()) {
+			return;
+		}
+		auto point = completed();
+		while (!pendingReleases.empty() && pendingReleases.front().point <= point) {
+			auto release = std::move(pendingReleases.front().release);
+			pendingReleases.pop_front();
+			release();
+		}
+	}
+
+	void FrameTimeline::retireFencesUpTo(uint64_t point) {
+		while (!pendingFences.empty() && pendingFences.front().point <= point) {
+			freeFences.push_back(pendingFences.front().fence);
+			pendingFences.pop_front();
+		}
+		completedPoint = std::max(completedPoint, point);
+	}
+}
@@ -0,0 +1,68 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_FRAME_TIMELINE_HPP
+#define VULKAN_ENGINE_FRAME_TIMELINE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+
+namespace Graphics {
+	/*
+	 * Numbers every graphics queue submission with a point counting up from 1, so any subsystem can ask whether
+	 * the GPU finished point N, wait for it, or defer releasing a resource until then without owning a fence.
+	 * A point completes only after everything submitted before it, because a submission's signal operation covers
+	 * all commands earlier in submission order on its queue.
+	 * Points are the values of a timeline semaphore when the device supports them, otherwise every submission
+	 * gets a fence from a recycled pool.
+	 */
+	class FrameTimeline {
+	public:
+		explicit FrameTimeline(Device& device);
+		FrameTimeline(FrameTimeline const&) = delete;
+		FrameTimeline& operator=(FrameTimeline const&) = delete;
+
+		// Submits to the graphics queue and returns the point that completes with it
+		uint64_t submit(vk::SubmitInfo submitInfo);
+		uint64_t lastSubmitted() const;
+		// Latest point known to have finished on the GPU, never blocks
+		uint64_t completed();
+		bool isComplete(uint64_t point);
+		// Blocks until point finished, returns immediately for points that are complete or 0
+		void wait(uint64_t point);
+
+		// Calls release once everything submitted so far finished, from a later collect or wait
+		void release(std::function<void()> release);
+		// Runs the releases that became safe, never blocks
+		void collect();
+	private:
+		struct PendingFence {
+			uint64_t point;
+			vk::Fence fence;
+		};
+		struct PendingRelease {
+			uint64_t point;
+			std::function<void()> release;
+		};
+
+		Device& device;
+		bool timelineSemaphore;
+		vk::Semaphore semaphore;
+		// Fence fallback, in submission order
+		std::deque<PendingFence> pendingFences;
+		std::vector<vk::Fence> freeFences;
+		std::deque<PendingRelease> pendingReleases;
+		uint64_t submitted = 0;
+		uint64_t completedPoint = 0;
+
+		void retireFencesUpTo(uint64_t point);
+	};
+}
+
+#endif //VULKAN_ENGINE_FRAME_TIMELINE_HPP
@@ -46,6 +46,16 @@ namespace Graphics {
 		delete[] attachments;
 	}
 
+	void Image::destroy(vma::Allocator& allocator, Device& device) {
+		device.destroyImageView(view);
+		if (allocation) {
+			allocator.destroyImage(image, *allocation);
+		}
+		image = vk::Image{};
+		view = vk::ImageView{};
+		allocation.reset();
+	}
+
 	Image::operator vk::Image() {
 		return image;
 	}
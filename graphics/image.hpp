@@ -22,6 +22,9 @@ namespace Graphics {
 		Image(vk::Image image, vk::ImageView view);
 		~Image();
 
+		// Destroys the view, and the image with its memory if this image owns an allocation
+		void destroy(vma::Allocator& allocator, Device& device);
+
 		operator vk::Image(); // NOLINT
 		operator vk::ImageView(); // NOLINT
 	private:
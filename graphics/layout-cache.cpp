@@ -0,0 +1,147 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "layout-cache.hpp"
+#include "../logger/logger.hpp"
+#include "../util/hash.hpp"
+
+namespace Graphics {
+	LayoutCache::LayoutCache(Device& device): device(device) {}
+
+	vk::PipelineLayout LayoutCache::pipelineLayout(std::vector<ShaderReflection const*> const& stages) {
+		// A binding or push constant range several stages declare becomes one that all of them see
+		std::vector<DescriptorBinding> bindings;
+		std::optional<vk::PushConstantRange> pushConstants;
+		for (auto stage : stages) {
+			for (auto binding : stage->bindings) {
+				if (binding.type == vk::DescriptorType::eUniformBuffer) {
+					binding.type = vk::DescriptorType::eUniformBufferDynamic;
+				}
+				auto existing = std::find_if(bindings.begin(), bindings.end(), [&](DescriptorBinding const& other) {
+					return other.set == binding.set && other.binding == binding.binding;
+				});
+				if (existing == bindings.end()) {
+					bindings.push_back(binding);
+					continue;
+				}
+				Logger::assertTrue(existing->type == binding.type && existing->count == binding.count,
+					"Shader stages disagree on set " + std::to_string(binding.set) + ", binding " +
+					std::to_string(binding.binding));
+				existing->stages |= binding.stages;
+			}
+
+			if (!stage->pushConstants) {
+				continue;
+			}
+			if (!pushConstants) {
+				pushConstants = stage->pushConstants;
+				continue;
+			}
+			auto end = std::max(pushConstants->offset + pushConstants->size,
+				stage->pushConstants->offset + stage->pushConstants->size);
+			pushConstants->offset = std::min(pushConstants->offset, stage->pushConstants->offset);
+			pushConstants->size = end - pushConstants->offset;
+			pushConstants->stageFlags |= stage->pushConstants->stageFlags;
+		}
+		std::sort(bindings.begin(), bindings.end(), [](DescriptorBinding const& a, DescriptorBinding const& b) {
+			return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+		});
+
+		std::lock_guard<std::mutex> lock(mutex);
+		std::vector<vk::DescriptorSetLayout> setLayouts;
+		uint32_t setCount = bindings.empty() ? 0u : bindings.back().set + 1u;
+		auto first = bindings.begin();
+		for (uint32_t set = 0; set < setCount; ++set) {
+			auto end = std::find_if(first, bindings.end(), [set](DescriptorBinding const& binding) {
+				return binding.set != set;
+			});
+			setLayouts.push_back(setLayout({first, end}));
+			first = end;
+		}
+		std::vector<vk::PushConstantRange> pushConstantRanges;
+		if (pushConstants) {
+			pushConstantRanges.push_back(*pushConstants);
+		}
+
+		auto key = Util::hash64(pushConstantRanges.data(), pushConstantRanges.size() * sizeof(vk::PushConstantRange),
+			Util::hash64(setLayouts.data(), setLayouts.size() * sizeof(vk::DescriptorSetLayout)));
+		auto cached = pipelineLayoutsByHash.find(key);
+		if (cached != pipelineLayoutsByHash.end()) {
+			Logger::assertTrue(cached->second.setLayouts == setLayouts &&
+				cached->second.pushConstantRanges == pushConstantRanges, "Pipeline layout hash collision");
+			return cached->second.layout;
+		}
+
+		auto layout = device.createPipelineLayout({
+			{},
+			static_cast<uint32_t>(setLayouts.size()),
+			setLayouts.data(),
+			static_cast<uint32_t>(pushConstantRanges.size()),
+			pushConstantRanges.data()
+		});
+		pipelineLayoutsByHash.emplace(key, PipelineLayout{setLayouts, pushConstantRanges, layout});
+		Logger::log("Created pipeline layout with ", setLayouts.size(), " descriptor sets and ",
+			pushConstants ? pushConstants->size : 0u, " bytes of push constants");
+		return layout;
+	}
+
+	std::vector<vk::DescriptorSetLayout> LayoutCache::setLayouts(vk::PipelineLayout layout) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto const& [key, pipelineLayout] : pipelineLayoutsByHash) {
+			if (pipelineLayout.layout == layout) {
+				return pipelineLayout.setLayouts;
+			}
+		}
+		throw Logger::error("Pipeline layout was not created by the layout cache");
+	}
+
+	std::vector<vk::DescriptorPoolSize> LayoutCache::poolSizes(vk::DescriptorSetLayout layout, uint32_t count) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto const& [key, setLayout] : setLayoutsByHash) {
+			if (setLayout.layout != layout) {
+				continue;
+			}
+			std::vector<vk::DescriptorPoolSize> sizes;
+			for (auto const& binding : setLayout.bindings) {
+				auto size = std::find_if(sizes.begin(), sizes.end(), [&](vk::DescriptorPoolSize const& other) {
+					return other.type == binding.type;
+				});
+				if (size == sizes.end()) {
+					sizes.emplace_back(binding.type, binding.count * count);
+				} else {
+					size->descriptorCount += binding.count * count;
+				}
+			}
+			return sizes;
+		}
+		throw Logger::error("Descriptor set layout was not created by the layout cache");
+	}
+
+	// Called with the mutex held
+	vk::DescriptorSetLayout LayoutCache::setLayout(std::vector<DescriptorBinding> const& bindings) {
+		auto key = Util::hash64(bindings.data(), bindings.size() * sizeof(DescriptorBinding));
+		auto cached = setLayoutsByHash.find(key);
+		if (cached != setLayoutsByHash.end()) {
+			Logger::assertTrue(cached->second.bindings == bindings, "Descriptor set layout hash collision");
+			return cached->second.layout;
+		}
+
+		std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
+		for (auto const& binding : bindings) {
+			layoutBindings.emplace_back(binding.binding, binding.type, binding.count, binding.stages);
+		}
+		auto layout = device.createDescriptorSetLayout({
+			{},
+			static_cast<uint32_t>(layoutBindings.size()),
+			layoutBindings.data()
+		});
+		setLayoutsByHash.emplace(key, SetLayout{bindings, layout});
+		return layout;
+	}
+}
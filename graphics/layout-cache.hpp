@@ -0,0 +1,57 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_LAYOUT_CACHE_HPP
+#define VULKAN_ENGINE_LAYOUT_CACHE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+#include "shader-reflection.hpp"
+
+namespace Graphics {
+	/*
+	 * Builds descriptor set and pipeline layouts from the reflected interfaces of a pipeline's shader stages.
+	 * Layouts are cached by the hash of what they are made of, so pipelines whose shaders declare the same
+	 * resources share one layout and stay compatible for descriptor sets bound across pipeline switches.
+	 * Uniform buffers always become dynamic bindings, the renderer streams them through the uniform ring.
+	 * Safe to use from several threads.
+	 */
+	class LayoutCache {
+	public:
+		explicit LayoutCache(Device& device);
+		LayoutCache(LayoutCache const&) = delete;
+		LayoutCache& operator=(LayoutCache const&) = delete;
+
+		vk::PipelineLayout pipelineLayout(std::vector<ShaderReflection const*> const& stages);
+		// Indexed by set, sets no stage uses get an empty layout
+		std::vector<vk::DescriptorSetLayout> setLayouts(vk::PipelineLayout layout);
+		// Descriptors a pool needs to allocate count sets with the layout
+		std::vector<vk::DescriptorPoolSize> poolSizes(vk::DescriptorSetLayout layout, uint32_t count);
+	private:
+		struct SetLayout {
+			std::vector<DescriptorBinding> bindings;
+			vk::DescriptorSetLayout layout;
+		};
+
+		struct PipelineLayout {
+			std::vector<vk::DescriptorSetLayout> setLayouts;
+			std::vector<vk::PushConstantRange> pushConstantRanges;
+			vk::PipelineLayout layout;
+		};
+
+		Device& device;
+		std::mutex mutex;
+		std::unordered_map<uint64_t, SetLayout> setLayoutsByHash;
+		std::unordered_map<uint64_t, PipelineLayout> pipelineLayoutsByHash;
+
+		vk::DescriptorSetLayout setLayout(std::vector<DescriptorBinding> const& bindings);
+	};
+}
+
+#endif //VULKAN_ENGINE_LAYOUT_CACHE_HPP
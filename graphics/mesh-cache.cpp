@@ -0,0 +1,186 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include "mesh-cache.hpp"
+#include "../logger/logger.hpp"
+#include "../util/atomic-file.hpp"
+#include "../util/hash.hpp"
+
+namespace Graphics {
+	namespace {
+		char const magic[4] = {'V', 'E', 'M', 'C'};
+
+		int64_t modifiedTime(std::filesystem::path const& path) {
+			return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+		}
+
+		bool inRange(uint32_t first, uint32_t count, uint32_t total) {
+			return static_cast<uint64_t>(first) + count <= total;
+		}
+	}
+
+	MeshCache::MeshCache(std::string directory): directory(std::move(directory)) {}
+
+	std::string MeshCache::cachePathFor(std::string const& sourcePath) {
+		return (std::filesystem::path(directory) / std::filesystem::path(sourcePath).filename()).string() + ".mesh";
+	}
+
+	uint64_t MeshCache::hashFile(std::string const& path) {
+		Util::MappedFile file(path);
+		return Util::hash64(file.data(), file.size());
+	}
+
+	std::optional<Mesh> MeshCache::load(std::string const& sourcePath, MeshOptions const& options) {
+		auto cachePath = cachePathFor(sourcePath);
+		std::error_code error;
+		if (!std::filesystem::exists(cachePath, error)) {
+			return {};
+		}
+
+		Util::MappedFile file(cachePath);
+		if (file.size() < sizeof(Header)) {
+			return {};
+		}
+
+		Header header{};
+		memcpy(&header, file.data(), sizeof(Header));
+		if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+			header.vertexFormat != static_cast<uint32_t>(options.vertexFormat) ||
+			header.vertexSize != vertexStride(options.vertexFormat) || (header.meshlets != 0u) != options.meshlets ||
+			header.lodLimit != options.lodCount || header.lodCount == 0u) {
+			return {};
+		}
+
+		if (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t)) {
+			return {};
+		}
+
+		uint64_t vertexEnd = header.vertexOffset + static_cast<uint64_t>(header.vertexCount) * header.vertexSize;
+		uint64_t indexEnd = header.indexOffset + static_cast<uint64_t>(header.indexCount) * header.indexSize;
+		uint64_t submeshEnd = header.submeshOffset + static_cast<uint64_t>(header.submeshCount) * sizeof(Submesh);
+		uint64_t meshletEnd = header.meshletOffset + static_cast<uint64_t>(header.meshletCount) * sizeof(Meshlet);
+		uint64_t lodEnd = header.lodOffset + static_cast<uint64_t>(header.lodCount) * sizeof(MeshLod);
+		if (vertexEnd > file.size() || indexEnd > file.size() || submeshEnd > file.size() || meshletEnd > file.size() ||
+			lodEnd > file.size()) {
+			Logger::log("Mesh cache ", cachePath, " is truncated, reloading ", sourcePath);
+			return {};
+		}
+
+		MeshLayout layout{
+			options.vertexFormat,
+			Dequantization{
+				glm::vec3{header.dequantizationScale[0], header.dequantizationScale[1], header.dequantizationScale[2]},
+				glm::vec3{header.dequantizationOffset[0], header.dequantizationOffset[1], header.dequantizationOffset[2]}
+			},
+			header.vertexOffset,
+			header.vertexCount,
+			header.indexSize == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32,
+			header.indexOffset,
+			header.indexCount,
+			std::vector<Submesh>(header.submeshCount),
+			std::vector<Meshlet>(header.meshletCount),
+			std::vector<MeshLod>(header.lodCount),
+			glm::vec3{header.boundsCenter[0], header.boundsCenter[1], header.boundsCenter[2]},
+			header.boundsRadius
+		};
+		memcpy(layout.submeshes.data(), file.data() + header.submeshOffset, header.submeshCount * sizeof(Submesh));
+		memcpy(layout.meshlets.data(), file.data() + header.meshletOffset, header.meshletCount * sizeof(Meshlet));
+		memcpy(layout.lods.data(), file.data() + header.lodOffset, header.lodCount * sizeof(MeshLod));
+
+		// Draws index straight into these ranges on the CPU and the GPU, a corrupt table must not get that far
+		bool rangesValid = std::all_of(layout.submeshes.begin(), layout.submeshes.end(), [&](Submesh const& submesh) {
+			return inRange(submesh.firstIndex, submesh.indexCount, header.indexCount);
+		}) && std::all_of(layout.meshlets.begin(), layout.meshlets.end(), [&](Meshlet const& meshlet) {
+			return inRange(meshlet.firstIndex, meshlet.indexCount, header.indexCount);
+		}) && std::all_of(layout.lods.begin(), layout.lods.end(), [&](MeshLod const& lod) {
+			return inRange(lod.firstIndex, lod.indexCount, header.indexCount) &&
+				inRange(lod.firstSubmesh, lod.submeshCount, header.submeshCount) &&
+				inRange(lod.firstMeshlet, lod.meshletCount, header.meshletCount);
+		});
+		if (!rangesValid) {
+			Logger::log("Mesh cache ", cachePath, " has ranges outside its tables, reloading ", sourcePath);
+			return {};
+		}
+
+		// Without the source there is nothing to compare against, the cache is all we have
+		auto sourceSize = std::filesystem::file_size(sourcePath, error);
+		if (error) {
+			return Mesh(std::move(file), std::move(layout));
+		}
+
+		if (sourceSize != header.sourceSize) {
+			return {};
+		}
+
+		if (modifiedTime(sourcePath) != header.sourceModifiedTime) {
+			if (hashFile(sourcePath) != header.sourceHash) {
+				return {};
+			}
+
+			// Contents are unchanged (e.g. the file was touched), refresh the timestamp so the hash is skipped next time.
+			// The entry is replaced as a whole rather than patched in place, the mapping keeps the old file alive.
+			header.sourceModifiedTime = modifiedTime(sourcePath);
+			try {
+				Util::writeFileAtomically(cachePath, {
+					{&header, sizeof(Header)},
+					{file.data() + sizeof(Header), file.size() - sizeof(Header)}
+				});
+			} catch (std::exception const& exception) {
+				Logger::log("Failed to refresh mesh cache ", cachePath, ": ", exception.what());
+			}
+		}
+
+		return Mesh(std::move(file), std::move(layout));
+	}
+
+	void MeshCache::store(std::string const& sourcePath, Mesh const& mesh, MeshOptions const& options) {
+		auto cachePath = cachePathFor(sourcePath);
+
+		Header header{};
+		memcpy(header.magic, magic, sizeof(magic));
+		header.version = version;
+		header.sourceSize = std::filesystem::file_size(sourcePath);
+		header.sourceModifiedTime = modifiedTime(sourcePath);
+		header.sourceHash = hashFile(sourcePath);
+		header.vertexSize = mesh.vertexStride();
+		header.vertexCount = mesh.vertexCount();
+		header.indexCount = mesh.indexCount();
+		header.vertexFormat = static_cast<uint32_t>(mesh.vertexFormat());
+		header.vertexOffset = sizeof(Header);
+		header.indexOffset = header.vertexOffset + mesh.vertexDataSize();
+		header.indexSize = mesh.indexType() == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		header.submeshCount = static_cast<uint32_t>(mesh.submeshes().size());
+		// 16-bit index blobs can end on a 2 byte boundary, keep the submesh table aligned
+		header.submeshOffset = (header.indexOffset + mesh.indexDataSize() + 3u) & ~uint64_t{3u};
+		header.meshletCount = static_cast<uint32_t>(mesh.meshlets().size());
+		header.meshletOffset = header.submeshOffset + mesh.submeshes().size() * sizeof(Submesh);
+		header.lodCount = static_cast<uint32_t>(mesh.lods().size());
+		header.lodLimit = options.lodCount;
+		header.meshlets = options.meshlets ? 1u : 0u;
+		header.lodOffset = header.meshletOffset + mesh.meshlets().size() * sizeof(Meshlet);
+		for (int axis = 0; axis < 3; ++axis) {
+			header.boundsCenter[axis] = mesh.boundsCenter()[axis];
+		}
+		header.boundsRadius = mesh.boundsRadius();
+		for (int axis = 0; axis < 3; ++axis) {
+			header.dequantizationScale[axis] = mesh.dequantization().scale[axis];
+			header.dequantizationOffset[axis] = mesh.dequantization().offset[axis];
+		}
+
+		char const padding[4] = {};
+		Util::writeFileAtomically(cachePath, {
+			{&header, sizeof(Header)},
+			{mesh.vertexData(), mesh.vertexDataSize()},
+			{mesh.indexData(), mesh.indexDataSize()},
+			{padding, header.submeshOffset - header.indexOffset - mesh.indexDataSize()},
+			{mesh.submeshes().data(), mesh.submeshes().size() * sizeof(Submesh)},
+			{mesh.meshlets().data(), mesh.meshlets().size() * sizeof(Meshlet)},
+			{mesh.lods().data(), mesh.lods().size() * sizeof(MeshLod)}
+		});
+	}
+}
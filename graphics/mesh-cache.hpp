@@ -0,0 +1,69 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MESH_CACHE_HPP
+#define VULKAN_ENGINE_MESH_CACHE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "mesh.hpp"
+
+namespace Graphics {
+	/*
+	 * Versioned binary mesh format, written after a model is first loaded from its source file and
+	 * memory-mapped on later launches. Layout: header, vertex blob in the mesh's vertex format, index blob,
+	 * submesh table, meshlet table,
+	 * level of detail table.
+	 * Entries are invalidated by source file size and modification time, falling back to a content hash
+	 * when only the modification time differs.
+	 */
+	class MeshCache {
+	public:
+		explicit MeshCache(std::string directory);
+
+		// Entries built with other options than requested are treated as stale
+		std::optional<Mesh> load(std::string const& sourcePath, MeshOptions const& options);
+		void store(std::string const& sourcePath, Mesh const& mesh, MeshOptions const& options);
+	private:
+		static uint32_t const version = 7u;
+
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint64_t sourceSize;
+			int64_t sourceModifiedTime;
+			uint64_t sourceHash;
+			uint32_t vertexSize;
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint32_t vertexFormat;
+			uint64_t vertexOffset;
+			uint64_t indexOffset;
+			float dequantizationScale[3];
+			float dequantizationOffset[3];
+			uint32_t indexSize;
+			uint32_t submeshCount;
+			uint64_t submeshOffset;
+			uint32_t meshletCount;
+			uint32_t lodCount;
+			uint64_t meshletOffset;
+			uint64_t lodOffset;
+			float boundsCenter[3];
+			float boundsRadius;
+			// MeshOptions::lodCount the entry was built with, the actual count can be lower
+			uint32_t lodLimit;
+			// MeshOptions::meshlets the entry was built with, a mesh can legitimately end up with no meshlets
+			uint32_t meshlets;
+		};
+
+		std::string directory;
+
+		std::string cachePathFor(std::string const& sourcePath);
+		static uint64_t hashFile(std::string const& path);
+	};
+}
+
+#endif //VULKAN_ENGINE_MESH_CACHE_HPP
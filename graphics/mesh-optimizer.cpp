@@ -0,0 +1,276 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <numeric>
+
+#include "mesh-optimizer.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t const unused = UINT32_MAX;
+
+		/*
+		 * FIFO post-transform cache in the form Tipsify uses: a vertex is cached while fewer than cacheSize
+		 * misses happened since it was transformed. reset() invalidates everything in O(1).
+		 */
+		class CacheSimulation {
+		public:
+			CacheSimulation(size_t vertexCount, uint32_t cacheSize)
+				: cacheTimes(vertexCount, 0u), cacheSize(cacheSize), timestamp(cacheSize + 1u) {}
+
+			bool contains(uint32_t vertex) const {
+				return timestamp - cacheTimes[vertex] <= cacheSize;
+			}
+
+			// Returns the number of misses the triangle causes
+			uint32_t access(uint32_t const* triangle) {
+				uint32_t misses = 0;
+				for (uint32_t k = 0; k < 3u; ++k) {
+					if (!contains(triangle[k])) {
+						cacheTimes[triangle[k]] = timestamp++;
+						++misses;
+					}
+				}
+				return misses;
+			}
+
+			void reset() {
+				timestamp += cacheSize + 1u;
+			}
+
+			std::vector<uint32_t> cacheTimes;
+			uint32_t cacheSize;
+			uint32_t timestamp;
+		};
+
+		struct Adjacency {
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> triangles;
+			std::vector<uint32_t> counts;
+		};
+
+		Adjacency buildAdjacency(std::vector<uint32_t> const& indices, size_t vertexCount) {
+			Adjacency adjacency;
+			adjacency.counts.assign(vertexCount, 0u);
+			for (auto index : indices) {
+				++adjacency.counts[index];
+			}
+
+			adjacency.offsets.assign(vertexCount + 1u, 0u);
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+				adjacency.offsets[vertex + 1u] = adjacency.offsets[vertex] + adjacency.counts[vertex];
+			}
+
+			adjacency.triangles.resize(indices.size());
+			std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3u);
+			}
+			return adjacency;
+		}
+
+		// Sorts clusters [boundaries[i], boundaries[i + 1]) of triangles outward facing first
+		std::vector<uint32_t> sortClusters(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+										   std::vector<uint32_t> const& boundaries) {
+			glm::vec3 meshCentroid{0.0f, 0.0f, 0.0f};
+			for (auto index : indices) {
+				meshCentroid += vertices[index].position;
+			}
+			meshCentroid /= static_cast<float>(std::max<size_t>(indices.size(), 1u));
+
+			size_t triangleCount = indices.size() / 3u;
+			std::vector<float> sortKeys(boundaries.size());
+			for (size_t cluster = 0; cluster < boundaries.size(); ++cluster) {
+				size_t end = cluster + 1u < boundaries.size() ? boundaries[cluster + 1u] : triangleCount;
+				glm::vec3 centroid{0.0f, 0.0f, 0.0f};
+				glm::vec3 normal{0.0f, 0.0f, 0.0f};
+				float area = 0.0f;
+				for (size_t triangle = boundaries[cluster]; triangle < end; ++triangle) {
+					auto p0 = vertices[indices[3u * triangle + 0u]].position;
+					auto p1 = vertices[indices[3u * triangle + 1u]].position;
+					auto p2 = vertices[indices[3u * triangle + 2u]].position;
+					auto triangleNormal = glm::cross(p1 - p0, p2 - p0);
+					float triangleArea = glm::length(triangleNormal);
+					centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+					normal += triangleNormal;
+					area += triangleArea;
+				}
+				float normalLength = glm::length(normal);
+				if (area > 0.0f && normalLength > 0.0f) {
+					sortKeys[cluster] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+				} else {
+					sortKeys[cluster] = 0.0f;
+				}
+			}
+
+			std::vector<uint32_t> order(boundaries.size());
+			std::iota(order.begin(), order.end(), 0u);
+			std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+				return sortKeys[a] > sortKeys[b];
+			});
+
+			std::vector<uint32_t> result;
+			result.reserve(indices.size());
+			for (auto cluster : order) {
+				size_t end = cluster + 1u < boundaries.size() ? boundaries[cluster + 1u] : triangleCount;
+				result.insert(result.end(), indices.begin() + 3u * boundaries[cluster], indices.begin() + 3u * end);
+			}
+			return result;
+		}
+	}
+
+	VertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount,
+											 uint32_t cacheSize) {
+		CacheSimulation cache(vertexCount, cacheSize);
+		std::vector<bool> referenced(vertexCount, false);
+		size_t misses = 0;
+		size_t uniqueVertices = 0;
+		for (size_t i = 0; i + 2u < indices.size(); i += 3u) {
+			misses += cache.access(&indices[i]);
+			for (size_t k = 0; k < 3u; ++k) {
+				if (!referenced[indices[i + k]]) {
+					referenced[indices[i + k]] = true;
+					++uniqueVertices;
+				}
+			}
+		}
+
+		size_t triangleCount = indices.size() / 3u;
+		return {
+			triangleCount ? static_cast<float>(misses) / static_cast<float>(triangleCount) : 0.0f,
+			uniqueVertices ? static_cast<float>(misses) / static_cast<float>(uniqueVertices) : 0.0f
+		};
+	}
+
+	std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount,
+											  uint32_t cacheSize) {
+		auto adjacency = buildAdjacency(indices, vertexCount);
+		std::vector<uint32_t>& liveTriangles = adjacency.counts;
+		std::vector<bool> emitted(indices.size() / 3u, false);
+		CacheSimulation cache(vertexCount, cacheSize);
+
+		std::vector<uint32_t> deadEnds;
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		uint32_t cursor = 0;
+		uint32_t fanningVertex = vertexCount > 0 ? 0u : unused;
+		while (fanningVertex != unused) {
+			candidates.clear();
+			for (uint32_t i = adjacency.offsets[fanningVertex]; i < adjacency.offsets[fanningVertex + 1u]; ++i) {
+				uint32_t triangle = adjacency.triangles[i];
+				if (emitted[triangle]) {
+					continue;
+				}
+				emitted[triangle] = true;
+				for (uint32_t k = 0; k < 3u; ++k) {
+					uint32_t vertex = indices[3u * triangle + k];
+					result.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					--liveTriangles[vertex];
+					if (!cache.contains(vertex)) {
+						cache.cacheTimes[vertex] = cache.timestamp++;
+					}
+				}
+			}
+
+			// Prefer the candidate that entered the cache earliest and will still be cached after being fanned
+			fanningVertex = unused;
+			int64_t bestPriority = -1;
+			for (auto vertex : candidates) {
+				if (liveTriangles[vertex] == 0u) {
+					continue;
+				}
+				int64_t age = static_cast<int64_t>(cache.timestamp) - cache.cacheTimes[vertex];
+				int64_t priority = age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize ? age : 0;
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					fanningVertex = vertex;
+				}
+			}
+
+			// Dead end: back up through recently used vertices, then scan for any vertex with triangles left
+			while (fanningVertex == unused && !deadEnds.empty()) {
+				uint32_t vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (liveTriangles[vertex] > 0u) {
+					fanningVertex = vertex;
+				}
+			}
+			while (fanningVertex == unused && cursor < vertexCount) {
+				if (liveTriangles[cursor] > 0u) {
+					fanningVertex = cursor;
+				}
+				++cursor;
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<uint32_t> optimizeOverdraw(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+										   float threshold, uint32_t cacheSize) {
+		size_t triangleCount = indices.size() / 3u;
+		if (triangleCount == 0u) {
+			return indices;
+		}
+
+		CacheSimulation cache(vertices.size(), cacheSize);
+		std::vector<uint32_t> misses(triangleCount);
+		std::vector<uint32_t> hardBoundaries;
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+			misses[triangle] = cache.access(&indices[3u * triangle]);
+			if (triangle == 0u || misses[triangle] == 3u) {
+				hardBoundaries.push_back(static_cast<uint32_t>(triangle));
+			}
+		}
+
+		std::vector<uint32_t> boundaries;
+		for (size_t cluster = 0; cluster < hardBoundaries.size(); ++cluster) {
+			size_t start = hardBoundaries[cluster];
+			size_t end = cluster + 1u < hardBoundaries.size() ? hardBoundaries[cluster + 1u] : triangleCount;
+
+			cache.reset();
+			uint32_t clusterMisses = 0;
+			for (size_t triangle = start; triangle < end; ++triangle) {
+				clusterMisses += cache.access(&indices[3u * triangle]);
+			}
+			float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+			cache.reset();
+			size_t subclusterStart = start;
+			uint32_t runningMisses = 0;
+			boundaries.push_back(static_cast<uint32_t>(start));
+			for (size_t triangle = start; triangle < end; ++triangle) {
+				runningMisses += cache.access(&indices[3u * triangle]);
+				auto runningTriangles = static_cast<float>(triangle - subclusterStart + 1u);
+				if (triangle + 1u < end && static_cast<float>(runningMisses) / runningTriangles <= clusterThreshold) {
+					subclusterStart = triangle + 1u;
+					boundaries.push_back(static_cast<uint32_t>(subclusterStart));
+					runningMisses = 0;
+					cache.reset();
+				}
+			}
+		}
+
+		return sortClusters(indices, vertices, boundaries);
+	}
+
+	void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		std::vector<uint32_t> remap(vertices.size(), unused);
+		std::vector<Vertex> reordered;
+		reordered.reserve(vertices.size());
+		for (auto& index : indices) {
+			if (remap[index] == unused) {
+				remap[index] = static_cast<uint32_t>(reordered.size());
+				reordered.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+		vertices = std::move(reordered);
+	}
+}
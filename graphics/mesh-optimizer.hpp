@@ -0,0 +1,41 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MESH_OPTIMIZER_HPP
+#define VULKAN_ENGINE_MESH_OPTIMIZER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "vertex.hpp"
+
+namespace Graphics {
+	struct VertexCacheStatistics {
+		// Average cache miss ratio: transformed vertices per triangle, 0.5 is the lower bound on closed meshes
+		float acmr;
+		// Average transform to vertex ratio: transformed vertices per referenced vertex, 1.0 is optimal
+		float atvr;
+	};
+
+	// Simulates a FIFO post-transform cache of the given size over the index order
+	VertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount,
+											 uint32_t cacheSize = 16u);
+
+	// Tipsify (Sander et al. 2007): reorders triangles for the post-transform cache
+	std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount,
+											  uint32_t cacheSize = 16u);
+
+	/*
+	 * Splits a cache-optimized index order into clusters (at cache flushes, then wherever a cluster prefix is
+	 * within threshold of the cluster's ACMR) and sorts clusters outward facing first, so that likely occluders
+	 * are drawn before what they occlude. Higher thresholds trade cache efficiency for less overdraw.
+	 */
+	std::vector<uint32_t> optimizeOverdraw(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+										   float threshold = 1.05f, uint32_t cacheSize = 16u);
+
+	// Reorders vertices into first-use order of the indices and drops unreferenced vertices
+	void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+}
+
+#endif //VULKAN_ENGINE_MESH_OPTIMIZER_HPP
@@ -0,0 +1,431 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "mesh-simplifier.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t const none = UINT32_MAX;
+		// Boundary planes are weighted heavily so open edges barely move
+		double const boundaryWeight = 10.0;
+		// Texture coordinate differences are measured in fractions of the mesh extent
+		float const attributeWeight = 0.1f;
+
+		struct Quadric {
+			double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+			double b2 = 0.0, bc = 0.0, bd = 0.0;
+			double c2 = 0.0, cd = 0.0;
+			double d2 = 0.0;
+			double weight = 0.0;
+
+			Quadric() = default;
+
+			// Plane through point with the given unit normal
+			Quadric(glm::vec3 const& normal, glm::vec3 const& point, double weight) : weight(weight) {
+				double a = normal.x, b = normal.y, c = normal.z;
+				double d = -glm::dot(normal, point);
+				a2 = a * a * weight; ab = a * b * weight; ac = a * c * weight; ad = a * d * weight;
+				b2 = b * b * weight; bc = b * c * weight; bd = b * d * weight;
+				c2 = c * c * weight; cd = c * d * weight;
+				d2 = d * d * weight;
+			}
+
+			Quadric& operator+=(Quadric const& other) {
+				a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+				b2 += other.b2; bc += other.bc; bd += other.bd;
+				c2 += other.c2; cd += other.cd;
+				d2 += other.d2;
+				weight += other.weight;
+				return *this;
+			}
+
+			// Weighted mean squared distance of point to the accumulated planes
+			double evaluate(glm::vec3 const& point) const {
+				double x = point.x, y = point.y, z = point.z;
+				double result = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+					2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+				return weight > 0.0 ? std::fabs(result) / weight : 0.0;
+			}
+		};
+
+		enum class VertexKind : uint8_t {
+			eManifold,
+			eBorder,
+			eSeam,
+			eLocked
+		};
+
+		struct Adjacency {
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> triangles;
+		};
+
+		Adjacency buildAdjacency(std::vector<uint32_t> const& indices, size_t vertexCount) {
+			Adjacency adjacency;
+			adjacency.offsets.assign(vertexCount + 1u, 0u);
+			for (auto index : indices) {
+				++adjacency.offsets[index + 1u];
+			}
+			std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+			adjacency.triangles.resize(indices.size());
+			std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3u);
+			}
+			return adjacency;
+		}
+
+		bool hasEdge(Adjacency const& adjacency, std::vector<uint32_t> const& indices, uint32_t from, uint32_t to) {
+			for (uint32_t i = adjacency.offsets[from]; i < adjacency.offsets[from + 1u]; ++i) {
+				uint32_t const* triangle = &indices[3u * adjacency.triangles[i]];
+				for (uint32_t k = 0; k < 3u; ++k) {
+					if (triangle[k] == from && triangle[(k + 1u) % 3u] == to) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		// Links every vertex to the next vertex with a bitwise identical position, in a cycle
+		std::vector<uint32_t> buildWedges(std::vector<Vertex> const& vertices) {
+			std::vector<uint32_t> order(vertices.size());
+			std::iota(order.begin(), order.end(), 0u);
+			auto key = [&](uint32_t vertex) {
+				auto const& position = vertices[vertex].position;
+				return std::make_tuple(position.x, position.y, position.z);
+			};
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+				return key(a) < key(b);
+			});
+
+			std::vector<uint32_t> wedges(vertices.size());
+			for (size_t start = 0; start < order.size();) {
+				size_t end = start + 1u;
+				while (end < order.size() && vertices[order[end]].position == vertices[order[start]].position) {
+					++end;
+				}
+				for (size_t i = start; i < end; ++i) {
+					wedges[order[i]] = order[i + 1u < end ? i + 1u : start];
+				}
+				start = end;
+			}
+			return wedges;
+		}
+
+		glm::vec3 triangleNormal(glm::vec3 const& p0, glm::vec3 const& p1, glm::vec3 const& p2) {
+			return glm::cross(p1 - p0, p2 - p0);
+		}
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double cost;
+		};
+
+		class Simplifier {
+		public:
+			Simplifier(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices)
+				: indices(indices), vertices(vertices), wedges(buildWedges(vertices)),
+				  openOut(vertices.size(), none), openIn(vertices.size(), none),
+				  kinds(vertices.size(), VertexKind::eLocked), quadrics(vertices.size()),
+				  remap(vertices.size()) {
+				std::iota(remap.begin(), remap.end(), 0u);
+
+				glm::vec3 minimum = vertices.empty() ? glm::vec3{0.0f, 0.0f, 0.0f} : vertices[0].position;
+				glm::vec3 maximum = minimum;
+				for (auto const& vertex : vertices) {
+					minimum = glm::min(minimum, vertex.position);
+					maximum = glm::max(maximum, vertex.position);
+				}
+				attributeScale = attributeWeight * glm::length(maximum - minimum);
+
+				classify();
+				accumulateQuadrics();
+			}
+
+			std::vector<uint32_t> simplify(size_t targetIndexCount, float& error) {
+				double maximumCost = 0.0;
+				while (indices.size() > targetIndexCount) {
+					size_t trianglesToRemove = (indices.size() - targetIndexCount) / 3u;
+					if (!collapsePass(trianglesToRemove, maximumCost)) {
+						break;
+					}
+				}
+				error = static_cast<float>(std::sqrt(maximumCost));
+				return indices;
+			}
+		private:
+			std::vector<uint32_t> indices;
+			std::vector<Vertex> const& vertices;
+			std::vector<uint32_t> wedges;
+			std::vector<uint32_t> openOut;
+			std::vector<uint32_t> openIn;
+			std::vector<VertexKind> kinds;
+			std::vector<Quadric> quadrics;
+			std::vector<uint32_t> remap;
+			float attributeScale = 0.0f;
+
+			uint32_t resolve(uint32_t vertex) {
+				while (vertex != none && remap[vertex] != vertex) {
+					remap[vertex] = remap[remap[vertex]];
+					vertex = remap[vertex];
+				}
+				return vertex;
+			}
+
+			void classify() {
+				auto adjacency = buildAdjacency(indices, vertices.size());
+				std::vector<uint8_t> openCount(vertices.size(), 0u);
+				std::vector<bool> referenced(vertices.size(), false);
+				for (size_t i = 0; i < indices.size(); i += 3u) {
+					for (uint32_t k = 0; k < 3u; ++k) {
+						uint32_t from = indices[i + k];
+						uint32_t to = indices[i + (k + 1u) % 3u];
+						referenced[from] = true;
+						if (!hasEdge(adjacency, indices, to, from)) {
+							// More than one open edge per direction marks a non-manifold vertex, the count saturates
+							openOut[from] = openOut[from] == none ? to : from;
+							openIn[to] = openIn[to] == none ? from : to;
+							openCount[from] = static_cast<uint8_t>(std::min(openCount[from] + 1, 255));
+							openCount[to] = static_cast<uint8_t>(std::min(openCount[to] + 1, 255));
+						}
+					}
+				}
+
+				// A single open edge in and out, and not pointing back at the vertex itself (the non-manifold marker)
+				auto simpleOpen = [&](uint32_t vertex) {
+					return openCount[vertex] == 2u && openOut[vertex] != vertex && openIn[vertex] != vertex &&
+						openOut[vertex] != none && openIn[vertex] != none;
+				};
+
+				for (uint32_t vertex = 0; vertex < vertices.size(); ++vertex) {
+					if (!referenced[vertex]) {
+						continue;
+					}
+					uint32_t twin = wedges[vertex];
+					if (twin == vertex) {
+						if (openCount[vertex] == 0u) {
+							kinds[vertex] = VertexKind::eManifold;
+						} else if (simpleOpen(vertex)) {
+							kinds[vertex] = VertexKind::eBorder;
+						}
+					} else if (wedges[twin] == vertex && simpleOpen(vertex) && simpleOpen(twin)) {
+						// Both sides of the seam run along the same positions in opposite directions
+						auto const& out = vertices[openOut[vertex]].position;
+						auto const& in = vertices[openIn[vertex]].position;
+						if (out == vertices[openIn[twin]].position && in == vertices[openOut[twin]].position) {
+							kinds[vertex] = VertexKind::eSeam;
+						}
+					}
+				}
+			}
+
+			void accumulateQuadrics() {
+				for (size_t i = 0; i < indices.size(); i += 3u) {
+					auto const& p0 = vertices[indices[i]].position;
+					auto const& p1 = vertices[indices[i + 1u]].position;
+					auto const& p2 = vertices[indices[i + 2u]].position;
+					auto normal = triangleNormal(p0, p1, p2);
+					float area = glm::length(normal);
+					if (area == 0.0f) {
+						continue;
+					}
+					normal /= area;
+					Quadric plane(normal, p0, area * 0.5);
+					for (uint32_t k = 0; k < 3u; ++k) {
+						quadrics[indices[i + k]] += plane;
+					}
+
+					// Planes perpendicular to the triangle through its open edges keep borders and seams in place
+					for (uint32_t k = 0; k < 3u; ++k) {
+						uint32_t from = indices[i + k];
+						uint32_t to = indices[i + (k + 1u) % 3u];
+						if (openOut[from] != to) {
+							continue;
+						}
+						auto edge = vertices[to].position - vertices[from].position;
+						float length = glm::length(edge);
+						if (length == 0.0f) {
+							continue;
+						}
+						auto edgeNormal = glm::normalize(glm::cross(edge, normal));
+						Quadric boundary(edgeNormal, vertices[from].position, boundaryWeight * length * length);
+						quadrics[from] += boundary;
+						quadrics[to] += boundary;
+					}
+				}
+			}
+
+			// For seam collapses twinFrom and twinTo receive the collapse on the other side of the seam
+			bool collapseAllowed(uint32_t from, uint32_t to, uint32_t& twinFrom, uint32_t& twinTo) {
+				twinFrom = none;
+				twinTo = none;
+				switch (kinds[from]) {
+					case VertexKind::eManifold:
+						return true;
+					case VertexKind::eBorder:
+						return resolve(openOut[from]) == to || resolve(openIn[from]) == to;
+					case VertexKind::eSeam: {
+						if (kinds[to] != VertexKind::eSeam) {
+							return false;
+						}
+						twinFrom = wedges[from];
+						if (resolve(openOut[from]) == to) {
+							twinTo = resolve(openIn[twinFrom]);
+						} else if (resolve(openIn[from]) == to) {
+							twinTo = resolve(openOut[twinFrom]);
+						} else {
+							return false;
+						}
+						return twinTo != none && wedges[to] == twinTo && wedges[twinTo] == to;
+					}
+					case VertexKind::eLocked:
+					default:
+						return false;
+				}
+			}
+
+			double collapseCost(uint32_t from, uint32_t to) {
+				auto uv = vertices[from].texCoord - vertices[to].texCoord;
+				double attributeError = static_cast<double>(uv.x * uv.x + uv.y * uv.y) * attributeScale * attributeScale;
+				return quadrics[from].evaluate(vertices[to].position) + attributeError;
+			}
+
+			// Moving from onto to must not turn any of its remaining triangles over
+			bool flips(Adjacency const& adjacency, uint32_t from, uint32_t to) {
+				auto const& target = vertices[to].position;
+				for (uint32_t i = adjacency.offsets[from]; i < adjacency.offsets[from + 1u]; ++i) {
+					uint32_t const* triangle = &indices[3u * adjacency.triangles[i]];
+					if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+						continue;
+					}
+					glm::vec3 before[3];
+					glm::vec3 after[3];
+					for (uint32_t k = 0; k < 3u; ++k) {
+						before[k] = vertices[triangle[k]].position;
+						after[k] = triangle[k] == from ? target : before[k];
+					}
+					auto normalBefore = triangleNormal(before[0], before[1], before[2]);
+					auto normalAfter = triangleNormal(after[0], after[1], after[2]);
+					if (glm::dot(normalBefore, normalAfter) <= 0.0f) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			uint32_t sharedTriangles(Adjacency const& adjacency, uint32_t from, uint32_t to) {
+				uint32_t count = 0;
+				for (uint32_t i = adjacency.offsets[from]; i < adjacency.offsets[from + 1u]; ++i) {
+					uint32_t const* triangle = &indices[3u * adjacency.triangles[i]];
+					count += triangle[0] == to || triangle[1] == to || triangle[2] == to ? 1u : 0u;
+				}
+				return count;
+			}
+
+			void lockNeighborhood(Adjacency const& adjacency, uint32_t vertex, std::vector<bool>& touched) {
+				for (uint32_t i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1u]; ++i) {
+					uint32_t const* triangle = &indices[3u * adjacency.triangles[i]];
+					touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+				}
+			}
+
+			void merge(uint32_t from, uint32_t to) {
+				quadrics[to] += quadrics[from];
+				remap[from] = to;
+				// The open edge between the two vertices disappeared, to continues along the one from had
+				if (resolve(openOut[to]) == to) {
+					openOut[to] = openOut[from];
+				}
+				if (resolve(openIn[to]) == to) {
+					openIn[to] = openIn[from];
+				}
+			}
+
+			/*
+			 * Collapses the cheapest edges whose neighborhoods do not overlap, so every cost and flip test in a
+			 * pass sees up to date positions. Returns false when nothing could be collapsed.
+			 */
+			bool collapsePass(size_t trianglesToRemove, double& maximumCost) {
+				auto adjacency = buildAdjacency(indices, vertices.size());
+
+				std::vector<Collapse> candidates;
+				candidates.reserve(indices.size() * 2u);
+				for (size_t i = 0; i < indices.size(); i += 3u) {
+					for (uint32_t k = 0; k < 3u; ++k) {
+						uint32_t a = indices[i + k];
+						uint32_t b = indices[i + (k + 1u) % 3u];
+						for (auto [from, to] : {std::make_pair(a, b), std::make_pair(b, a)}) {
+							uint32_t twinFrom, twinTo;
+							if (!collapseAllowed(from, to, twinFrom, twinTo)) {
+								continue;
+							}
+							double cost = collapseCost(from, to);
+							if (twinFrom != none) {
+								cost = std::max(cost, collapseCost(twinFrom, twinTo));
+							}
+							candidates.push_back(Collapse{from, to, cost});
+						}
+					}
+				}
+				std::sort(candidates.begin(), candidates.end(), [](Collapse const& a, Collapse const& b) {
+					return a.cost < b.cost;
+				});
+
+				std::vector<bool> touched(vertices.size(), false);
+				size_t removed = 0;
+				bool collapsed = false;
+				for (auto const& candidate : candidates) {
+					if (removed >= trianglesToRemove) {
+						break;
+					}
+					uint32_t twinFrom, twinTo;
+					collapseAllowed(candidate.from, candidate.to, twinFrom, twinTo);
+					if (touched[candidate.from] || touched[candidate.to] ||
+						(twinFrom != none && (touched[twinFrom] || touched[twinTo]))) {
+						continue;
+					}
+					if (flips(adjacency, candidate.from, candidate.to) ||
+						(twinFrom != none && flips(adjacency, twinFrom, twinTo))) {
+						continue;
+					}
+
+					removed += sharedTriangles(adjacency, candidate.from, candidate.to);
+					lockNeighborhood(adjacency, candidate.from, touched);
+					merge(candidate.from, candidate.to);
+					if (twinFrom != none) {
+						removed += sharedTriangles(adjacency, twinFrom, twinTo);
+						lockNeighborhood(adjacency, twinFrom, touched);
+						merge(twinFrom, twinTo);
+					}
+					maximumCost = std::max(maximumCost, candidate.cost);
+					collapsed = true;
+				}
+
+				if (collapsed) {
+					std::vector<uint32_t> remaining;
+					remaining.reserve(indices.size());
+					for (size_t i = 0; i < indices.size(); i += 3u) {
+						uint32_t a = resolve(indices[i]), b = resolve(indices[i + 1u]), c = resolve(indices[i + 2u]);
+						if (a != b && b != c && c != a) {
+							remaining.insert(remaining.end(), {a, b, c});
+						}
+					}
+					indices = std::move(remaining);
+				}
+				return collapsed;
+			}
+		};
+	}
+
+	std::vector<uint32_t> simplifyMesh(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+									   size_t targetIndexCount, float& error) {
+		return Simplifier(indices, vertices).simplify(targetIndexCount, error);
+	}
+}
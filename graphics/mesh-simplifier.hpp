@@ -0,0 +1,26 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MESH_SIMPLIFIER_HPP
+#define VULKAN_ENGINE_MESH_SIMPLIFIER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "vertex.hpp"
+
+namespace Graphics {
+	/*
+	 * Quadric error metric simplification (Garland and Heckbert 1997) by half-edge collapses, so the result
+	 * indexes the same vertices as the input. Open edges are kept in place by boundary quadrics; vertices on a
+	 * UV seam (two vertices sharing a position) only collapse along the seam and together with their twin, so
+	 * texture coordinates never bleed across seams. Texture coordinate changes add to the collapse cost.
+	 * Stops at targetIndexCount or when no collapse is left. error receives the largest accepted collapse cost
+	 * as a distance in model units.
+	 */
+	std::vector<uint32_t> simplifyMesh(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+									   size_t targetIndexCount, float& error);
+}
+
+#endif //VULKAN_ENGINE_MESH_SIMPLIFIER_HPP
@@ -0,0 +1,358 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include "mesh.hpp"
+#include "vertex-welder.hpp"
+#include "mesh-optimizer.hpp"
+#include "meshlet.hpp"
+#include "mesh-simplifier.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t const unmapped = UINT32_MAX;
+	}
+
+	Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
+		: ownedVertices(std::move(vertices)), ownedIndices(std::move(indices)) {
+		vertexPointer = reinterpret_cast<uint8_t const*>(ownedVertices.data());
+		indexPointer = reinterpret_cast<uint8_t const*>(ownedIndices.data());
+		numVertices = static_cast<uint32_t>(ownedVertices.size());
+		numIndices = static_cast<uint32_t>(ownedIndices.size());
+		resetRanges();
+
+		if (!ownedVertices.empty()) {
+			glm::vec3 minimum = ownedVertices[0].position;
+			glm::vec3 maximum = minimum;
+			for (auto const& vertex : ownedVertices) {
+				minimum = glm::min(minimum, vertex.position);
+				maximum = glm::max(maximum, vertex.position);
+			}
+			center = (minimum + maximum) * 0.5f;
+			for (auto const& vertex : ownedVertices) {
+				radius = std::max(radius, glm::length(vertex.position - center));
+			}
+		}
+	}
+
+	Mesh::Mesh(Util::MappedFile file, MeshLayout layout)
+		: file(std::move(file)), format(layout.vertexFormat), dequantizationParameters(layout.dequantization),
+		  indexWidth(layout.indexType), submeshRanges(std::move(layout.submeshes)),
+		  meshletRanges(std::move(layout.meshlets)), lodRanges(std::move(layout.lods)), center(layout.boundsCenter),
+		  radius(layout.boundsRadius), numVertices(layout.vertexCount), numIndices(layout.indexCount) {
+		vertexPointer = reinterpret_cast<uint8_t const*>(this->file.data() + layout.vertexOffset);
+		indexPointer = reinterpret_cast<uint8_t const*>(this->file.data() + layout.indexOffset);
+	}
+
+	Mesh Mesh::loadObj(std::string const& path) {
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+		Logger::assertTrue(tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()),
+			"Failed to load object: " + warn + err);
+
+		VertexWelder welder(attrib.vertices.size() / 3u);
+		std::vector<uint32_t> indices;
+		for (const auto& shape : shapes) {
+			for (const auto& index : shape.mesh.indices) {
+				Vertex vertex{
+					glm::vec3{
+						attrib.vertices[3 * index.vertex_index + 0],
+						attrib.vertices[3 * index.vertex_index + 1],
+						attrib.vertices[3 * index.vertex_index + 2]
+					},
+					glm::vec3{1.0f, 1.0f, 1.0f},
+					glm::vec2{
+						attrib.texcoords[2 * index.texcoord_index + 0],
+						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+					}
+				};
+				indices.push_back(welder.weld(vertex));
+			}
+		}
+
+		return Mesh(welder.takeVertices(), std::move(indices));
+	}
+
+	void Mesh::optimize() {
+		Logger::assertTrue(format == VertexFormat::eStandard && !ownedVertices.empty() &&
+			indexWidth == vk::IndexType::eUint32 && !ownedIndices.empty(),
+			"Only meshes owning unpacked data can be optimized");
+
+		auto before = analyzeVertexCache(ownedIndices, ownedVertices.size());
+		ownedIndices = optimizeVertexCache(ownedIndices, ownedVertices.size());
+		ownedIndices = optimizeOverdraw(ownedIndices, ownedVertices);
+		optimizeVertexFetch(ownedVertices, ownedIndices);
+		auto after = analyzeVertexCache(ownedIndices, ownedVertices.size());
+		Logger::log("Mesh optimization: ACMR ", before.acmr, " -> ", after.acmr,
+			", ATVR ", before.atvr, " -> ", after.atvr);
+
+		vertexPointer = reinterpret_cast<uint8_t const*>(ownedVertices.data());
+		indexPointer = reinterpret_cast<uint8_t const*>(ownedIndices.data());
+		numVertices = static_cast<uint32_t>(ownedVertices.size());
+		numIndices = static_cast<uint32_t>(ownedIndices.size());
+		resetRanges();
+	}
+
+	void Mesh::buildLods(uint32_t lodCount) {
+		Logger::assertTrue(format == VertexFormat::eStandard && !ownedVertices.empty() &&
+			indexWidth == vk::IndexType::eUint32 && lodRanges.size() == 1u,
+			"Levels of detail can only be built once, from unpacked data");
+
+		std::vector<std::vector<uint32_t>> levels{ownedIndices};
+		std::vector<float> errors{0.0f};
+		while (levels.size() < lodCount) {
+			auto const& previous = levels.back();
+			float error = 0.0f;
+			auto simplified = simplifyMesh(previous, ownedVertices, previous.size() / 6u * 3u, error);
+			// Levels that barely shrink cost memory without saving vertex work
+			if (simplified.empty() || simplified.size() > previous.size() * 9u / 10u) {
+				break;
+			}
+			simplified = optimizeVertexCache(simplified, ownedVertices.size());
+			simplified = optimizeOverdraw(simplified, ownedVertices);
+			// Deviations of consecutive levels add up, relative to full detail
+			errors.push_back(errors.back() + error);
+			levels.push_back(std::move(simplified));
+			Logger::log("LOD ", levels.size() - 1u, ": ", levels.back().size() / 3u, " triangles, error ",
+				errors.back());
+		}
+
+		// Coarsest level first, so each level references a prefix of the reordered vertices
+		std::vector<uint32_t> indices;
+		for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+			indices.insert(indices.end(), level->begin(), level->end());
+		}
+		optimizeVertexFetch(ownedVertices, indices);
+
+		ownedIndices.clear();
+		lodRanges.clear();
+		size_t levelEnd = indices.size();
+		for (size_t level = 0; level < levels.size(); ++level) {
+			size_t levelStart = levelEnd - levels[level].size();
+			lodRanges.push_back(MeshLod{static_cast<uint32_t>(ownedIndices.size()),
+				static_cast<uint32_t>(levels[level].size()), 0u, 0u, 0u, 0u, errors[level]});
+			ownedIndices.insert(ownedIndices.end(), indices.begin() + levelStart, indices.begin() + levelEnd);
+			levelEnd = levelStart;
+		}
+
+		vertexPointer = reinterpret_cast<uint8_t const*>(ownedVertices.data());
+		indexPointer = reinterpret_cast<uint8_t const*>(ownedIndices.data());
+		numVertices = static_cast<uint32_t>(ownedVertices.size());
+		numIndices = static_cast<uint32_t>(ownedIndices.size());
+		submeshRanges.clear();
+		for (auto& lod : lodRanges) {
+			lod.firstSubmesh = static_cast<uint32_t>(submeshRanges.size());
+			lod.submeshCount = 1u;
+			submeshRanges.push_back(Submesh{lod.firstIndex, lod.indexCount, 0});
+		}
+		meshletRanges.clear();
+	}
+
+	void Mesh::pack(VertexFormat targetFormat) {
+		if (targetFormat == format) {
+			return;
+		}
+		Logger::assertTrue(format == VertexFormat::eStandard && !ownedVertices.empty(),
+			"Only meshes owning unpacked vertices can be packed");
+
+		// Only ePacked exists besides the standard layout
+		dequantizationParameters = PackedVertex::dequantizationFor(ownedVertices);
+		ownedVertexData.resize(ownedVertices.size() * sizeof(PackedVertex));
+		auto packedVertices = reinterpret_cast<PackedVertex*>(ownedVertexData.data());
+		for (size_t i = 0; i < ownedVertices.size(); ++i) {
+			packedVertices[i] = PackedVertex::pack(ownedVertices[i], dequantizationParameters);
+		}
+		Logger::log("Packed ", ownedVertices.size(), " vertices from ", sizeof(Vertex), " to ", sizeof(PackedVertex),
+			" bytes each");
+
+		ownedVertices = {};
+		format = targetFormat;
+		vertexPointer = ownedVertexData.data();
+	}
+
+	void Mesh::narrowIndices() {
+		if (indexWidth == vk::IndexType::eUint16) {
+			return;
+		}
+		Logger::assertTrue(format == VertexFormat::eStandard && !ownedVertices.empty() && !ownedIndices.empty(),
+			"Only meshes owning unpacked data can be narrowed");
+
+		// Levels whose vertices all fit below the limit keep using the shared vertices directly
+		uint32_t const limit = 1u << 16u;
+		uint32_t sharedVertices = 0;
+		std::vector<bool> split(lodRanges.size(), false);
+		for (size_t level = 0; level < lodRanges.size(); ++level) {
+			auto const& lod = lodRanges[level];
+			auto end = ownedIndices.begin() + lod.firstIndex + lod.indexCount;
+			uint32_t maximum = lod.indexCount ? *std::max_element(ownedIndices.begin() + lod.firstIndex, end) : 0u;
+			split[level] = maximum >= limit;
+			if (!split[level]) {
+				sharedVertices = std::max(sharedVertices, maximum + 1u);
+			}
+		}
+
+		std::vector<Vertex> vertices(ownedVertices.begin(), ownedVertices.begin() + sharedVertices);
+		std::vector<uint32_t> localIndex(ownedVertices.size(), unmapped);
+		std::vector<uint32_t> owner(ownedVertices.size(), unmapped);
+		std::vector<Submesh> ranges;
+		ownedShortIndices.resize(ownedIndices.size());
+		for (size_t level = 0; level < lodRanges.size(); ++level) {
+			auto& lod = lodRanges[level];
+			lod.firstSubmesh = static_cast<uint32_t>(ranges.size());
+			uint32_t end = lod.firstIndex + lod.indexCount;
+			if (!split[level]) {
+				ranges.push_back(Submesh{lod.firstIndex, lod.indexCount, 0});
+				for (uint32_t i = lod.firstIndex; i < end; ++i) {
+					ownedShortIndices[i] = static_cast<uint16_t>(ownedIndices[i]);
+				}
+				lod.submeshCount = 1u;
+				continue;
+			}
+
+			// Vertices are in first-use order, so a submesh mostly maps onto a contiguous run of the original vertices
+			for (uint32_t i = lod.firstIndex; i + 2u < end; i += 3u) {
+				auto submesh = static_cast<uint32_t>(ranges.size() - 1u);
+				bool first = i == lod.firstIndex;
+				uint32_t newVertices = 0;
+				for (uint32_t k = 0; k < 3u && !first; ++k) {
+					newVertices += owner[ownedIndices[i + k]] != submesh ? 1u : 0u;
+				}
+				if (first || vertices.size() - static_cast<size_t>(ranges.back().vertexOffset) + newVertices > limit) {
+					ranges.push_back(Submesh{i, 0u, static_cast<int32_t>(vertices.size())});
+					submesh = static_cast<uint32_t>(ranges.size() - 1u);
+				}
+
+				for (uint32_t k = 0; k < 3u; ++k) {
+					auto vertex = ownedIndices[i + k];
+					if (owner[vertex] != submesh) {
+						owner[vertex] = submesh;
+						localIndex[vertex] = static_cast<uint32_t>(vertices.size() - ranges.back().vertexOffset);
+						vertices.push_back(ownedVertices[vertex]);
+					}
+					ownedShortIndices[i + k] = static_cast<uint16_t>(localIndex[vertex]);
+				}
+				ranges.back().indexCount += 3u;
+			}
+			lod.submeshCount = static_cast<uint32_t>(ranges.size()) - lod.firstSubmesh;
+		}
+		Logger::log("Narrowed ", numIndices, " indices to 16 bits in ", ranges.size(), " submeshes, vertex count ",
+			ownedVertices.size(), " -> ", vertices.size());
+
+		ownedVertices = std::move(vertices);
+		ownedIndices = {};
+		indexWidth = vk::IndexType::eUint16;
+		vertexPointer = reinterpret_cast<uint8_t const*>(ownedVertices.data());
+		indexPointer = reinterpret_cast<uint8_t const*>(ownedShortIndices.data());
+		numVertices = static_cast<uint32_t>(ownedVertices.size());
+		submeshRanges = std::move(ranges);
+		meshletRanges = {};
+	}
+
+	void Mesh::buildMeshlets() {
+		Logger::assertTrue(format == VertexFormat::eStandard && !ownedVertices.empty(),
+			"Only meshes owning unpacked data can be partitioned into meshlets");
+
+		std::vector<uint32_t> indices(numIndices);
+		for (auto const& submesh : submeshRanges) {
+			for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i) {
+				auto index = indexWidth == vk::IndexType::eUint16 ? ownedShortIndices[i] : ownedIndices[i];
+				indices[i] = index + static_cast<uint32_t>(submesh.vertexOffset);
+			}
+		}
+		meshletRanges.clear();
+		for (auto& lod : lodRanges) {
+			std::vector<Submesh> submeshes(submeshRanges.begin() + lod.firstSubmesh,
+				submeshRanges.begin() + lod.firstSubmesh + lod.submeshCount);
+			auto meshlets = Graphics::buildMeshlets(indices, ownedVertices, submeshes);
+			lod.firstMeshlet = static_cast<uint32_t>(meshletRanges.size());
+			lod.meshletCount = static_cast<uint32_t>(meshlets.size());
+			meshletRanges.insert(meshletRanges.end(), meshlets.begin(), meshlets.end());
+		}
+		Logger::log("Partitioned ", numIndices / 3u, " triangles into ", meshletRanges.size(), " meshlets");
+	}
+
+	void const* Mesh::vertexData() const {
+		return vertexPointer;
+	}
+
+	void const* Mesh::indexData() const {
+		return indexPointer;
+	}
+
+	uint32_t Mesh::vertexCount() const {
+		return numVertices;
+	}
+
+	uint32_t Mesh::indexCount() const {
+		return numIndices;
+	}
+
+	vk::DeviceSize Mesh::vertexDataSize() const {
+		return Graphics::vertexStride(format) * static_cast<vk::DeviceSize>(numVertices);
+	}
+
+	vk::DeviceSize Mesh::indexDataSize() const {
+		vk::DeviceSize indexSize = indexWidth == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		return indexSize * static_cast<vk::DeviceSize>(numIndices);
+	}
+
+	vk::IndexType Mesh::indexType() const {
+		return indexWidth;
+	}
+
+	std::vector<Submesh> const& Mesh::submeshes() const {
+		return submeshRanges;
+	}
+
+	std::vector<Meshlet> const& Mesh::meshlets() const {
+		return meshletRanges;
+	}
+
+	std::vector<MeshLod> const& Mesh::lods() const {
+		return lodRanges;
+	}
+
+	glm::vec3 const& Mesh::boundsCenter() const {
+		return center;
+	}
+
+	float Mesh::boundsRadius() const {
+		return radius;
+	}
+
+	VertexFormat Mesh::vertexFormat() const {
+		return format;
+	}
+
+	uint32_t Mesh::vertexStride() const {
+		return Graphics::vertexStride(format);
+	}
+
+	Dequantization const& Mesh::dequantization() const {
+		return dequantizationParameters;
+	}
+
+	void Mesh::release() {
+		ownedVertices = {};
+		ownedVertexData = {};
+		ownedIndices = {};
+		ownedShortIndices = {};
+		file.unmap();
+		vertexPointer = nullptr;
+		indexPointer = nullptr;
+	}
+
+	void Mesh::resetRanges() {
+		submeshRanges = {Submesh{0u, numIndices, 0}};
+		meshletRanges = {};
+		lodRanges = {MeshLod{0u, numIndices, 0u, 1u, 0u, 0u, 0.0f}};
+	}
+}
@@ -0,0 +1,152 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MESH_HPP
+#define VULKAN_ENGINE_MESH_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "vertex.hpp"
+#include "../util/mapped-file.hpp"
+
+namespace Graphics {
+	// Range of the index buffer drawn with one drawIndexed call, indices are relative to vertexOffset
+	struct Submesh {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		int32_t vertexOffset;
+	};
+
+	// Submesh range small enough to be culled as a unit, with a bounding sphere and a cone containing its normals
+	struct Meshlet {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		int32_t vertexOffset;
+		glm::vec3 center;
+		float radius;
+		glm::vec3 coneAxis;
+		// Sine of the cone's half angle, 1 when the meshlet cannot be backface culled
+		float coneCutoff;
+	};
+
+	// Level of detail, its index range is split into consecutive submeshes and meshlets
+	struct MeshLod {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		uint32_t firstSubmesh;
+		uint32_t submeshCount;
+		uint32_t firstMeshlet;
+		uint32_t meshletCount;
+		// Largest deviation from the full detail surface in model units
+		float error;
+	};
+
+	// Processing applied to a mesh after loading, cached meshes built with other options are stale
+	struct MeshOptions {
+		VertexFormat vertexFormat = VertexFormat::ePacked;
+		bool meshlets = true;
+		// Maximum number of levels of detail including the full detail mesh, each halving the triangle count
+		uint32_t lodCount = 4u;
+	};
+
+	// Where the parts of a mesh live inside a memory-mapped mesh cache file
+	struct MeshLayout {
+		VertexFormat vertexFormat;
+		Dequantization dequantization;
+		size_t vertexOffset;
+		uint32_t vertexCount;
+		vk::IndexType indexType;
+		size_t indexOffset;
+		uint32_t indexCount;
+		std::vector<Submesh> submeshes;
+		std::vector<Meshlet> meshlets;
+		std::vector<MeshLod> lods;
+		glm::vec3 boundsCenter;
+		float boundsRadius;
+	};
+
+	/*
+	 * CPU side vertex and index data of a model, ready to be copied into staging buffers. The data is
+	 * either owned (freshly loaded) or a view into a memory-mapped mesh cache file. Vertices are in the
+	 * standard Vertex layout until pack() converts them to a compact format.
+	 */
+	class Mesh {
+	public:
+		Mesh() = default;
+		Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices);
+		Mesh(Util::MappedFile file, MeshLayout layout);
+
+		static Mesh loadObj(std::string const& path);
+
+		// Reorders freshly loaded data for the post-transform vertex cache, overdraw and vertex fetch
+		void optimize();
+
+		/*
+		 * Appends simplified copies of the index buffer, each with about half the triangles of the previous
+		 * level, until lodCount levels exist or simplification stops making progress. All levels share the
+		 * vertex buffer, which is reordered so coarser levels reference a prefix of it. Runs after optimize().
+		 */
+		void buildLods(uint32_t lodCount);
+
+		// Converts owned vertices into the given format, must run after every pass that reads positions
+		void pack(VertexFormat format);
+
+		/*
+		 * Switches to 16-bit indices. Levels of detail referencing more than 65536 vertices are split into
+		 * consecutive submeshes that each address at most 65536 vertices from their base vertex, with copies of
+		 * the vertices they use; vertices shared by two submeshes are duplicated. Must run after every pass that
+		 * reads indices and before pack().
+		 */
+		void narrowIndices();
+
+		// Partitions the submeshes into meshlets for cluster culling, must run after narrowIndices() and before pack()
+		void buildMeshlets();
+
+		void const* vertexData() const;
+		void const* indexData() const;
+		uint32_t vertexCount() const;
+		uint32_t indexCount() const;
+		vk::DeviceSize vertexDataSize() const;
+		vk::DeviceSize indexDataSize() const;
+		vk::IndexType indexType() const;
+		std::vector<Submesh> const& submeshes() const;
+		std::vector<Meshlet> const& meshlets() const;
+		std::vector<MeshLod> const& lods() const;
+		glm::vec3 const& boundsCenter() const;
+		float boundsRadius() const;
+		VertexFormat vertexFormat() const;
+		uint32_t vertexStride() const;
+		// Identity for the standard format, the mesh bounds for packed formats
+		Dequantization const& dequantization() const;
+
+		// Drops the CPU copy of the data once it has been uploaded, counts and ranges remain valid
+		void release();
+	private:
+		std::vector<Vertex> ownedVertices;
+		std::vector<uint8_t> ownedVertexData;
+		std::vector<uint32_t> ownedIndices;
+		std::vector<uint16_t> ownedShortIndices;
+		Util::MappedFile file;
+		VertexFormat format = VertexFormat::eStandard;
+		Dequantization dequantizationParameters{glm::vec3{1.0f, 1.0f, 1.0f}, glm::vec3{0.0f, 0.0f, 0.0f}};
+		uint8_t const* vertexPointer = nullptr;
+		uint8_t const* indexPointer = nullptr;
+		vk::IndexType indexWidth = vk::IndexType::eUint32;
+		std::vector<Submesh> submeshRanges;
+		std::vector<Meshlet> meshletRanges;
+		std::vector<MeshLod> lodRanges;
+		glm::vec3 center{0.0f, 0.0f, 0.0f};
+		float radius = 0.0f;
+		uint32_t numVertices = 0;
+		uint32_t numIndices = 0;
+
+		// A single level of detail and submesh covering all indices, without meshlets
+		void resetRanges();
+	};
+}
+
+#endif //VULKAN_ENGINE_MESH_HPP
@@ -0,0 +1,130 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "meshlet.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t const unused = UINT32_MAX;
+
+		void computeBounds(Meshlet& meshlet, std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices) {
+			uint32_t end = meshlet.firstIndex + meshlet.indexCount;
+			glm::vec3 minimum = vertices[indices[meshlet.firstIndex]].position;
+			glm::vec3 maximum = minimum;
+			for (uint32_t i = meshlet.firstIndex; i < end; ++i) {
+				minimum = glm::min(minimum, vertices[indices[i]].position);
+				maximum = glm::max(maximum, vertices[indices[i]].position);
+			}
+			meshlet.center = (minimum + maximum) * 0.5f;
+			meshlet.radius = 0.0f;
+			for (uint32_t i = meshlet.firstIndex; i < end; ++i) {
+				meshlet.radius = std::max(meshlet.radius, glm::length(vertices[indices[i]].position - meshlet.center));
+			}
+
+			std::vector<glm::vec3> normals;
+			normals.reserve(meshlet.indexCount / 3u);
+			glm::vec3 axis{0.0f, 0.0f, 0.0f};
+			for (uint32_t i = meshlet.firstIndex; i + 2u < end; i += 3u) {
+				auto p0 = vertices[indices[i]].position;
+				auto normal = glm::cross(vertices[indices[i + 1u]].position - p0, vertices[indices[i + 2u]].position - p0);
+				float length = glm::length(normal);
+				if (length > 0.0f) {
+					normals.push_back(normal / length);
+					axis += normals.back();
+				}
+			}
+
+			// A cutoff of 1 never culls, used when the triangles face more than a hemisphere apart
+			meshlet.coneAxis = glm::vec3{0.0f, 0.0f, 1.0f};
+			meshlet.coneCutoff = 1.0f;
+			float axisLength = glm::length(axis);
+			if (axisLength == 0.0f) {
+				return;
+			}
+			axis /= axisLength;
+			float minimumDot = 1.0f;
+			for (auto const& normal : normals) {
+				minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+			}
+			meshlet.coneAxis = axis;
+			if (minimumDot > 0.0f) {
+				meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+			}
+		}
+	}
+
+	std::vector<Meshlet> buildMeshlets(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+									   std::vector<Submesh> const& submeshes, uint32_t maxVertices,
+									   uint32_t maxTriangles) {
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> owner(vertices.size(), unused);
+		for (auto const& submesh : submeshes) {
+			uint32_t end = submesh.firstIndex + submesh.indexCount;
+			uint32_t vertexCount = 0;
+			for (uint32_t i = submesh.firstIndex; i + 2u < end; i += 3u) {
+				auto current = static_cast<uint32_t>(meshlets.size() - 1u);
+				uint32_t newVertices = 0;
+				for (uint32_t k = 0; k < 3u && !meshlets.empty(); ++k) {
+					newVertices += owner[indices[i + k]] != current ? 1u : 0u;
+				}
+				if (i == submesh.firstIndex || vertexCount + newVertices > maxVertices ||
+					meshlets.back().indexCount == 3u * maxTriangles) {
+					meshlets.push_back(Meshlet{i, 0u, submesh.vertexOffset, {}, 0.0f, {}, 1.0f});
+					current = static_cast<uint32_t>(meshlets.size() - 1u);
+					vertexCount = 0;
+				}
+				for (uint32_t k = 0; k < 3u; ++k) {
+					if (owner[indices[i + k]] != current) {
+						owner[indices[i + k]] = current;
+						++vertexCount;
+					}
+				}
+				meshlets.back().indexCount += 3u;
+			}
+		}
+
+		for (auto& meshlet : meshlets) {
+			computeBounds(meshlet, indices, vertices);
+		}
+		return meshlets;
+	}
+
+	uint32_t cullMeshlets(Meshlet const* meshlets, size_t meshletCount, glm::mat4 const& modelViewProjection,
+						  glm::vec3 const& cameraPosition, vk::DrawIndexedIndirectCommand* commands) {
+		auto row = [&](int i) {
+			return glm::vec4{modelViewProjection[0][i], modelViewProjection[1][i], modelViewProjection[2][i],
+				modelViewProjection[3][i]};
+		};
+		// Gribb-Hartmann planes in model space, the near plane is z >= 0 in Vulkan clip space
+		std::array<glm::vec4, 6> planes{
+			row(3) + row(0), row(3) - row(0),
+			row(3) + row(1), row(3) - row(1),
+			row(2), row(3) - row(2)
+		};
+		for (auto& plane : planes) {
+			plane /= glm::length(glm::vec3{plane.x, plane.y, plane.z});
+		}
+
+		uint32_t visible = 0;
+		for (size_t i = 0; i < meshletCount; ++i) {
+			auto const& meshlet = meshlets[i];
+			bool inside = std::all_of(planes.begin(), planes.end(), [&](glm::vec4 const& plane) {
+				return glm::dot(glm::vec3{plane.x, plane.y, plane.z}, meshlet.center) + plane.w >= -meshlet.radius;
+			});
+			auto toCenter = meshlet.center - cameraPosition;
+			bool backFacing = glm::dot(toCenter, meshlet.coneAxis) >=
+				meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+
+			if (inside && !backFacing) {
+				commands[visible++] = vk::DrawIndexedIndirectCommand{meshlet.indexCount, 1u, meshlet.firstIndex,
+					meshlet.vertexOffset, 0u};
+			}
+		}
+		return visible;
+	}
+}
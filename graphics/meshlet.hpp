@@ -0,0 +1,35 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MESHLET_HPP
+#define VULKAN_ENGINE_MESHLET_HPP
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include "mesh.hpp"
+
+namespace Graphics {
+	/*
+	 * Splits every submesh into consecutive triangle runs referencing at most maxVertices unique vertices and
+	 * maxTriangles triangles. Indices are absolute (relative index plus the submesh's vertexOffset). The scan
+	 * follows the index order, which is spatially coherent after vertex cache optimization.
+	 */
+	std::vector<Meshlet> buildMeshlets(std::vector<uint32_t> const& indices, std::vector<Vertex> const& vertices,
+									   std::vector<Submesh> const& submeshes, uint32_t maxVertices = 64u,
+									   uint32_t maxTriangles = 124u);
+
+	/*
+	 * Writes an indirect draw for each visible meshlet into commands, packed in meshlet order. Meshlets outside the
+	 * frustum or whose normal cone faces away from the camera are skipped. The matrix maps model space to Vulkan
+	 * clip space and the camera position is in model space. Returns the number of draws written, commands needs
+	 * room for meshletCount of them.
+	 */
+	uint32_t cullMeshlets(Meshlet const* meshlets, size_t meshletCount, glm::mat4 const& modelViewProjection,
+						  glm::vec3 const& cameraPosition, vk::DrawIndexedIndirectCommand* commands);
+}
+
+#endif //VULKAN_ENGINE_MESHLET_HPP
@@ -0,0 +1,442 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#include "obj-loader.hpp"
+#include "vertex-welder.hpp"
+#include "../logger/logger.hpp"
+#include "../util/mapped-file.hpp"
+
+namespace Graphics {
+	namespace {
+		size_t const shardBits = 6u;
+		size_t const shardCount = size_t{1} << shardBits;
+
+		inline bool isSpace(char c) {
+			return c == ' ' || c == '\t';
+		}
+
+		inline bool isDigit(char c) {
+			return static_cast<unsigned int>(c - '0') < 10u;
+		}
+
+		inline char const* skipSpaces(char const* token, char const* end) {
+			while (token < end && isSpace(*token)) {
+				++token;
+			}
+			return token;
+		}
+
+		inline char const* skipUntil(char const* token, char const* end, char const* stops) {
+			while (token < end && !strchr(stops, *token)) {
+				++token;
+			}
+			return token;
+		}
+
+		/*
+		 * Same grammar and, more importantly, the same arithmetic as tinyobj's tryParseDouble, so that
+		 * every parsed value rounds to exactly the float tinyobj would produce.
+		 */
+		bool tryParseDouble(char const* s, char const* sEnd, double* result) {
+			if (s >= sEnd) {
+				return false;
+			}
+
+			double mantissa = 0.0;
+			int exponent = 0;
+			char sign = '+';
+			char exponentSign = '+';
+			char const* current = s;
+			int read = 0;
+			bool endNotReached;
+			bool leadingDecimalDots = false;
+
+			if (*current == '+' || *current == '-') {
+				sign = *current;
+				current++;
+				if (current != sEnd && *current == '.') {
+					leadingDecimalDots = true;
+				}
+			} else if (isDigit(*current)) {
+			} else if (*current == '.') {
+				leadingDecimalDots = true;
+			} else {
+				return false;
+			}
+
+			endNotReached = current != sEnd;
+			if (!leadingDecimalDots) {
+				while (endNotReached && isDigit(*current)) {
+					mantissa *= 10;
+					mantissa += static_cast<int>(*current - 0x30);
+					current++;
+					read++;
+					endNotReached = current != sEnd;
+				}
+				if (read == 0) {
+					return false;
+				}
+			}
+
+			if (endNotReached) {
+				if (*current == '.') {
+					current++;
+					read = 1;
+					endNotReached = current != sEnd;
+					while (endNotReached && isDigit(*current)) {
+						static double const powLut[] = {
+							1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001,
+						};
+						int const lutEntries = sizeof powLut / sizeof powLut[0];
+						mantissa += static_cast<int>(*current - 0x30) *
+							(read < lutEntries ? powLut[read] : std::pow(10.0, -read));
+						read++;
+						current++;
+						endNotReached = current != sEnd;
+					}
+				} else if (*current != 'e' && *current != 'E') {
+					endNotReached = false;
+				}
+			}
+
+			if (endNotReached && (*current == 'e' || *current == 'E')) {
+				current++;
+				endNotReached = current != sEnd;
+				if (endNotReached && (*current == '+' || *current == '-')) {
+					exponentSign = *current;
+					current++;
+				} else if (!(endNotReached && isDigit(*current))) {
+					return false;
+				}
+
+				read = 0;
+				endNotReached = current != sEnd;
+				while (endNotReached && isDigit(*current)) {
+					exponent *= 10;
+					exponent += static_cast<int>(*current - 0x30);
+					current++;
+					read++;
+					endNotReached = current != sEnd;
+				}
+				exponent *= exponentSign == '+' ? 1 : -1;
+				if (read == 0) {
+					return false;
+				}
+			}
+
+			*result = (sign == '+' ? 1 : -1) *
+				(exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+			return true;
+		}
+
+		float parseReal(char const** token, char const* end) {
+			*token = skipSpaces(*token, end);
+			char const* valueEnd = skipUntil(*token, end, " \t\r");
+			double value = 0.0;
+			tryParseDouble(*token, valueEnd, &value);
+			*token = valueEnd;
+			return static_cast<float>(value);
+		}
+
+		// atoi without running past the end of the line, the mapped file is not null terminated
+		int parseInt(char const* token, char const* end) {
+			while (token < end && (isSpace(*token) || *token == '\r')) {
+				++token;
+			}
+			bool negative = false;
+			if (token < end && (*token == '+' || *token == '-')) {
+				negative = *token == '-';
+				++token;
+			}
+			int value = 0;
+			while (token < end && isDigit(*token)) {
+				value = value * 10 + (*token - '0');
+				++token;
+			}
+			return negative ? -value : value;
+		}
+
+		// Same convention as tinyobj's fixIndex: one based, negative values are relative to the current count
+		bool fixIndex(int index, uint32_t count, uint32_t* result) {
+			if (index > 0) {
+				*result = static_cast<uint32_t>(index - 1);
+				return true;
+			}
+			if (index < 0 && static_cast<int64_t>(count) + index >= 0) {
+				*result = static_cast<uint32_t>(static_cast<int64_t>(count) + index);
+				return true;
+			}
+			return false;
+		}
+
+		template <typename LineCallback>
+		bool forEachLine(char const* begin, char const* end, LineCallback const& callback) {
+			char const* line = begin;
+			while (line < end) {
+				auto newline = static_cast<char const*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+				char const* lineEnd = newline ? newline : end;
+				char const* next = newline ? newline + 1 : end;
+				if (lineEnd > line && lineEnd[-1] == '\r') {
+					--lineEnd;
+				}
+				if (!callback(skipSpaces(line, lineEnd), lineEnd)) {
+					return false;
+				}
+				line = next;
+			}
+			return true;
+		}
+
+		enum class LineType {
+			ePosition,
+			eTexCoord,
+			eFace,
+			eOther
+		};
+
+		LineType classify(char const* token, char const* end) {
+			auto remaining = end - token;
+			if (remaining >= 2 && token[0] == 'v' && isSpace(token[1])) {
+				return LineType::ePosition;
+			}
+			if (remaining >= 3 && token[0] == 'v' && token[1] == 't' && isSpace(token[2])) {
+				return LineType::eTexCoord;
+			}
+			if (remaining >= 2 && token[0] == 'f' && isSpace(token[1])) {
+				return LineType::eFace;
+			}
+			return LineType::eOther;
+		}
+	}
+
+	ObjLoader::ObjLoader(Util::ThreadPool& threadPool): threadPool(threadPool) {}
+
+	std::optional<Mesh> ObjLoader::load(std::string const& path) {
+		Util::MappedFile file(path);
+		auto chunks = splitIntoChunks(file.data(), file.size());
+
+		threadPool.parallelFor(chunks.size(), [&](size_t i) {
+			countElements(chunks[i]);
+		});
+
+		uint32_t positionCount = 0, texCoordCount = 0, faceCount = 0;
+		for (auto& chunk : chunks) {
+			chunk.positionBase = positionCount;
+			chunk.texCoordBase = texCoordCount;
+			chunk.faceBase = faceCount;
+			positionCount += chunk.positionCount;
+			texCoordCount += chunk.texCoordCount;
+			faceCount += chunk.faceCount;
+		}
+
+		positions.resize(3u * positionCount);
+		texCoords.resize(2u * texCoordCount);
+		corners.resize(3u * faceCount);
+
+		std::atomic<bool> supported{true};
+		threadPool.parallelFor(chunks.size(), [&](size_t i) {
+			if (!parseChunk(chunks[i], positions.data(), texCoords.data(), corners.data())) {
+				supported = false;
+			}
+		});
+
+		bool inRange = true;
+		for (auto const& corner : corners) {
+			inRange &= corner.position < positionCount && corner.texCoord < texCoordCount;
+		}
+		if (!supported || !inRange || corners.empty()) {
+			return {};
+		}
+
+		auto mesh = deduplicate();
+		positions = {};
+		texCoords = {};
+		corners = {};
+		return mesh;
+	}
+
+	std::vector<ObjLoader::Chunk> ObjLoader::splitIntoChunks(char const* data, size_t size) {
+		size_t chunkCount = std::max<size_t>(1u, threadPool.size() * 4u);
+		size_t targetSize = size / chunkCount + 1u;
+
+		std::vector<Chunk> chunks;
+		chunks.reserve(chunkCount);
+		char const* end = data + size;
+		char const* begin = data;
+		while (begin < end) {
+			char const* chunkEnd = begin + std::min(targetSize, static_cast<size_t>(end - begin));
+			auto newline = static_cast<char const*>(memchr(chunkEnd - 1, '\n', static_cast<size_t>(end - chunkEnd + 1)));
+			chunkEnd = newline ? newline + 1 : end;
+			chunks.push_back({begin, chunkEnd, 0u, 0u, 0u, 0u, 0u, 0u});
+			begin = chunkEnd;
+		}
+		return chunks;
+	}
+
+	void ObjLoader::countElements(Chunk& chunk) {
+		forEachLine(chunk.begin, chunk.end, [&](char const* token, char const* end) {
+			switch (classify(token, end)) {
+				case LineType::ePosition:
+					++chunk.positionCount;
+					break;
+				case LineType::eTexCoord:
+					++chunk.texCoordCount;
+					break;
+				case LineType::eFace:
+					++chunk.faceCount;
+					break;
+				default:
+					break;
+			}
+			return true;
+		});
+	}
+
+	bool ObjLoader::parseChunk(Chunk const& chunk, float* positions, float* texCoords, Corner* corners) {
+		uint32_t positionIndex = chunk.positionBase;
+		uint32_t texCoordIndex = chunk.texCoordBase;
+		uint32_t cornerIndex = 3u * chunk.faceBase;
+
+		return forEachLine(chunk.begin, chunk.end, [&](char const* token, char const* end) {
+			switch (classify(token, end)) {
+				case LineType::ePosition: {
+					token += 2;
+					float* position = positions + 3u * positionIndex++;
+					position[0] = parseReal(&token, end);
+					position[1] = parseReal(&token, end);
+					position[2] = parseReal(&token, end);
+					return true;
+				}
+				case LineType::eTexCoord: {
+					token += 3;
+					float* texCoord = texCoords + 2u * texCoordIndex++;
+					texCoord[0] = parseReal(&token, end);
+					texCoord[1] = parseReal(&token, end);
+					return true;
+				}
+				case LineType::eFace: {
+					token = skipSpaces(token + 2, end);
+					uint32_t faceVertices = 0;
+					while (token < end && *token != '\r') {
+						if (faceVertices == 3u) {
+							return false; // Polygons are triangulated by tinyobj's ear clipping
+						}
+						Corner& corner = corners[cornerIndex + faceVertices++];
+						if (!fixIndex(parseInt(token, end), positionIndex, &corner.position)) {
+							return false;
+						}
+						token = skipUntil(token, end, "/ \t\r");
+						if (token == end || *token != '/' || token + 1 == end || token[1] == '/') {
+							return false; // Faces without texture coordinates
+						}
+						++token;
+						if (!fixIndex(parseInt(token, end), texCoordIndex, &corner.texCoord)) {
+							return false;
+						}
+						token = skipUntil(token, end, "/ \t\r");
+						if (token < end && *token == '/') {
+							++token;
+							if (parseInt(token, end) == 0) {
+								return false;
+							}
+							token = skipUntil(token, end, "/ \t\r");
+						}
+						while (token < end && (isSpace(*token) || *token == '\r')) {
+							++token;
+						}
+					}
+					cornerIndex += 3u;
+					return faceVertices == 3u;
+				}
+				default:
+					return true;
+			}
+		});
+	}
+
+	/*
+	 * Every corner is hashed and bucketed into a shard by the top bits of its hash, keeping corner order
+	 * within a shard. Each shard is welded independently, which finds the first corner carrying each
+	 * distinct vertex. A final in-order pass numbers those first occurrences, giving the same vertex order
+	 * and indices as welding corner by corner into a single VertexWelder.
+	 */
+	Mesh ObjLoader::deduplicate() {
+		auto cornerCount = corners.size();
+		auto vertexOf = [this](size_t corner) {
+			auto position = positions.data() + 3u * corners[corner].position;
+			auto texCoord = texCoords.data() + 2u * corners[corner].texCoord;
+			return Vertex{
+				glm::vec3{position[0], position[1], position[2]},
+				glm::vec3{1.0f, 1.0f, 1.0f},
+				glm::vec2{texCoord[0], 1.0f - texCoord[1]}
+			};
+		};
+
+		size_t blockCount = std::max<size_t>(1u, threadPool.size() * 4u);
+		size_t blockSize = (cornerCount + blockCount - 1u) / blockCount;
+		std::vector<uint64_t> hashes(cornerCount);
+		std::vector<uint32_t> blockShardCounts(blockCount * shardCount, 0u);
+
+		VertexWelder const hasher{};
+		threadPool.parallelFor(blockCount, [&](size_t block) {
+			auto counts = blockShardCounts.data() + block * shardCount;
+			for (size_t corner = block * blockSize; corner < std::min(cornerCount, (block + 1u) * blockSize); ++corner) {
+				hashes[corner] = hasher.hash(vertexOf(corner));
+				++counts[hashes[corner] >> (64u - shardBits)];
+			}
+		});
+
+		std::vector<size_t> shardBegin(shardCount + 1u, 0u);
+		std::vector<uint32_t> blockShardOffsets(blockCount * shardCount);
+		size_t offset = 0;
+		for (size_t shard = 0; shard < shardCount; ++shard) {
+			shardBegin[shard] = offset;
+			for (size_t block = 0; block < blockCount; ++block) {
+				blockShardOffsets[block * shardCount + shard] = static_cast<uint32_t>(offset);
+				offset += blockShardCounts[block * shardCount + shard];
+			}
+		}
+		shardBegin[shardCount] = offset;
+
+		std::vector<uint32_t> shardCorners(cornerCount);
+		threadPool.parallelFor(blockCount, [&](size_t block) {
+			auto offsets = blockShardOffsets.data() + block * shardCount;
+			for (size_t corner = block * blockSize; corner < std::min(cornerCount, (block + 1u) * blockSize); ++corner) {
+				shardCorners[offsets[hashes[corner] >> (64u - shardBits)]++] = static_cast<uint32_t>(corner);
+			}
+		});
+
+		std::vector<uint32_t> firstCorner(cornerCount);
+		threadPool.parallelFor(shardCount, [&](size_t shard) {
+			VertexWelder welder((shardBegin[shard + 1u] - shardBegin[shard]) / 4u);
+			std::vector<uint32_t> weldedFirstCorner;
+			for (size_t i = shardBegin[shard]; i < shardBegin[shard + 1u]; ++i) {
+				uint32_t corner = shardCorners[i];
+				uint32_t welded = welder.weld(vertexOf(corner), hashes[corner]);
+				if (welded == weldedFirstCorner.size()) {
+					weldedFirstCorner.push_back(corner);
+				}
+				firstCorner[corner] = weldedFirstCorner[welded];
+			}
+		});
+
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices(cornerCount);
+		for (size_t corner = 0; corner < cornerCount; ++corner) {
+			if (firstCorner[corner] == corner) {
+				firstCorner[corner] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(vertexOf(corner));
+			} else {
+				firstCorner[corner] = firstCorner[firstCorner[corner]];
+			}
+			indices[corner] = firstCorner[corner];
+		}
+
+		return Mesh(std::move(vertices), std::move(indices));
+	}
+}
@@ -0,0 +1,57 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_OBJ_LOADER_HPP
+#define VULKAN_ENGINE_OBJ_LOADER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mesh.hpp"
+#include "../util/thread-pool.hpp"
+
+namespace Graphics {
+	/*
+	 * Parallel OBJ loader for large triangulated models. The file is split into line-aligned chunks that are
+	 * parsed on the thread pool, then vertices are deduplicated in hash shards. Output is byte-identical to
+	 * Mesh::loadObj. Files using features only tinyobj handles (polygons, faces without texture coordinates)
+	 * are rejected so the caller can fall back to Mesh::loadObj.
+	 */
+	class ObjLoader {
+	public:
+		explicit ObjLoader(Util::ThreadPool& threadPool);
+
+		std::optional<Mesh> load(std::string const& path);
+	private:
+		struct Chunk {
+			char const* begin;
+			char const* end;
+			uint32_t positionCount;
+			uint32_t texCoordCount;
+			uint32_t faceCount;
+			uint32_t positionBase;
+			uint32_t texCoordBase;
+			uint32_t faceBase;
+		};
+
+		struct Corner {
+			uint32_t position;
+			uint32_t texCoord;
+		};
+
+		Util::ThreadPool& threadPool;
+		std::vector<float> positions;
+		std::vector<float> texCoords;
+		std::vector<Corner> corners;
+
+		std::vector<Chunk> splitIntoChunks(char const* data, size_t size);
+		static void countElements(Chunk& chunk);
+		static bool parseChunk(Chunk const& chunk, float* positions, float* texCoords, Corner* corners);
+		Mesh deduplicate();
+	};
+}
+
+#endif //VULKAN_ENGINE_OBJ_LOADER_HPP
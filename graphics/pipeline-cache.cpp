@@ -0,0 +1,87 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <cstring>
+#include <filesystem>
+
+#include "pipeline-cache.hpp"
+#include "../logger/logger.hpp"
+#include "../util/atomic-file.hpp"
+#include "../util/hash.hpp"
+#include "../util/mapped-file.hpp"
+
+namespace Graphics {
+	namespace {
+		char const magic[4] = {'V', 'E', 'P', 'C'};
+	}
+
+	PipelineCache::PipelineCache(Device& device, std::string path): device(device), path(std::move(path)) {
+		auto data = load();
+		warm = !data.empty();
+		loadedHash = Util::hash64(data.data(), data.size());
+		cache = device.createPipelineCache(data);
+	}
+
+	std::vector<uint8_t> PipelineCache::load() {
+		std::error_code error;
+		if (!std::filesystem::exists(path, error)) {
+			Logger::log("No pipeline cache at ", path, ", pipelines compile from scratch");
+			return {};
+		}
+
+		Util::MappedFile file(path);
+		Header header{};
+		if (file.size() < sizeof(Header)) {
+			return {};
+		}
+		memcpy(&header, file.data(), sizeof(Header));
+		if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+			header.dataSize != file.size() - sizeof(Header) || header.dataSize < sizeof(VulkanHeader) ||
+			Util::hash64(file.data() + sizeof(Header), header.dataSize) != header.dataHash) {
+			Logger::log("Pipeline cache ", path, " is corrupt, discarding it");
+			return {};
+		}
+
+		VulkanHeader vulkanHeader{};
+		memcpy(&vulkanHeader, file.data() + sizeof(Header), sizeof(VulkanHeader));
+		auto properties = device.getProperties();
+		if (vulkanHeader.headerSize < sizeof(VulkanHeader) ||
+			vulkanHeader.headerVersion != static_cast<uint32_t>(vk::PipelineCacheHeaderVersion::eOne) ||
+			vulkanHeader.vendorID != properties.vendorID || vulkanHeader.deviceID != properties.deviceID ||
+			memcmp(vulkanHeader.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0) {
+			Logger::log("Pipeline cache ", path, " was built by another device or driver, discarding it");
+			return {};
+		}
+
+		auto begin = reinterpret_cast<uint8_t const*>(file.data()) + sizeof(Header);
+		Logger::log("Loaded pipeline cache ", path, " (", header.dataSize, " bytes)");
+		return std::vector<uint8_t>(begin, begin + header.dataSize);
+	}
+
+	void PipelineCache::save() {
+		auto data = device.getPipelineCacheData(cache);
+		auto dataHash = Util::hash64(data.data(), data.size());
+		if (data.empty() || dataHash == loadedHash) {
+			return;
+		}
+
+		Header header{};
+		memcpy(header.magic, magic, sizeof(magic));
+		header.version = version;
+		header.dataSize = data.size();
+		header.dataHash = dataHash;
+
+		Util::writeFileAtomically(path, {{&header, sizeof(Header)}, {data.data(), data.size()}});
+		loadedHash = dataHash;
+		Logger::log("Saved pipeline cache ", path, " (", data.size(), " bytes)");
+	}
+
+	bool PipelineCache::isWarm() const {
+		return warm;
+	}
+
+	PipelineCache::operator vk::PipelineCache() {
+		return cache;
+	}
+}
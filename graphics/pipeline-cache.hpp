@@ -0,0 +1,62 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_CACHE_HPP
+#define VULKAN_ENGINE_PIPELINE_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+
+namespace Graphics {
+	/*
+	 * Vulkan pipeline cache persisted between launches. The file wraps the driver's cache data in a small header
+	 * with its size and hash; data whose Vulkan header names another vendor, device or pipeline cache UUID is
+	 * dropped instead of handed to the driver. Saving writes a temporary file and renames it over the old one.
+	 */
+	class PipelineCache {
+	public:
+		PipelineCache(Device& device, std::string path);
+		PipelineCache(PipelineCache const&) = delete;
+		PipelineCache& operator=(PipelineCache const&) = delete;
+
+		// Writes the cache back unless nothing was added since it was loaded
+		void save();
+		// Whether pipelines can hit in data from an earlier launch
+		bool isWarm() const;
+
+		operator vk::PipelineCache(); // NOLINT
+	private:
+		static uint32_t const version = 1u;
+
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint64_t dataSize;
+			uint64_t dataHash;
+		};
+
+		// Layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE at the start of the driver's data
+		struct VulkanHeader {
+			uint32_t headerSize;
+			uint32_t headerVersion;
+			uint32_t vendorID;
+			uint32_t deviceID;
+			uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+		};
+
+		Device& device;
+		std::string path;
+		vk::PipelineCache cache;
+		bool warm = false;
+		uint64_t loadedHash = 0;
+
+		std::vector<uint8_t> load();
+	};
+}
+
+#endif //VULKAN_ENGINE_PIPELINE_CACHE_HPP
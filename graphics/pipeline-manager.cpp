@@ -0,0 +1,284 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+
+#include "pipeline-manager.hpp"
+#include "shader.hpp"
+#include "../logger/logger.hpp"
+#include "../util/hash.hpp"
+
+namespace Graphics {
+	namespace {
+		// Background compiles are rare and bursty, one worker keeps them off the cores recording frames
+		size_t const compileThreads = 1u;
+
+		// Modules are only needed until the pipeline is created, this destroys them on every way out of compile,
+		// so failed compiles of hot reloaded shaders do not leak them
+		struct ScopedShader {
+			Shader shader;
+			Device& device;
+
+			ScopedShader(std::string const& name, Device& device, vk::ShaderStageFlagBits stage)
+				: shader(name, &device, stage), device(device) {}
+			ScopedShader(ScopedShader const&) = delete;
+			ScopedShader& operator=(ScopedShader const&) = delete;
+			~ScopedShader() {
+				shader.destroy(&device);
+			}
+		};
+
+		void copyName(char (&destination)[32], std::string const& name) {
+			Logger::assertTrue(name.size() < sizeof(destination), "Shader name too long: " + name);
+			memset(destination, 0, sizeof(destination));
+			memcpy(destination, name.data(), name.size());
+		}
+	}
+
+	PipelineState::PipelineState() { // NOLINT
+		memset(this, 0, sizeof(PipelineState));
+		cullMode = vk::CullModeFlagBits::eBack;
+		depthTest = true;
+		depthWrite = true;
+		samples = vk::SampleCountFlagBits::e1;
+	}
+
+	void PipelineState::setShaders(std::string const& vertex, std::string const& fragment) {
+		copyName(vertexShader, vertex);
+		copyName(fragmentShader, fragment);
+	}
+
+	uint64_t PipelineState::hash() const {
+		return Util::hash64(this, sizeof(PipelineState));
+	}
+
+	bool PipelineState::operator==(PipelineState const& other) const {
+		return memcmp(this, &other, sizeof(PipelineState)) == 0;
+	}
+
+	PipelineManager::PipelineManager(Device& device, vk::PipelineCache cache, LayoutCache& layouts,
+									 vk::RenderPass renderPass)
+		: device(device), cache(cache), layouts(layouts), renderPass(renderPass), compiler(compileThreads) {}
+
+	PipelineManager::~PipelineManager() {
+		// Workers may still be compiling with this manager, wait for them before anything goes away
+		for (auto& [key, entry] : pipelines) {
+			if (!entry.failed) {
+				abandoned.push_back(entry.pipeline);
+			}
+		}
+		destroyAbandoned(true);
+	}
+
+	vk::Pipeline PipelineManager::get(PipelineState const& state) {
+		auto key = state.hash();
+		if (auto entry = find(state, key)) {
+			return entry->pipeline.get();
+		}
+		std::promise<vk::Pipeline> compiled;
+		compiled.set_value(compile(state));
+		pipelines.emplace(key, Entry{state, compiled.get_future().share()});
+		return pipelines.at(key).pipeline.get();
+	}
+
+	vk::Pipeline PipelineManager::request(PipelineState const& state) {
+		auto key = state.hash();
+		auto entry = find(state, key);
+		if (!entry) {
+			pipelines.emplace(key, Entry{state, compiler.submit([this, state]() { return compile(state); }).share()});
+			return {};
+		}
+		if (entry->failed || entry->pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			return {};
+		}
+		try {
+			return entry->pipeline.get();
+		} catch (std::exception const& exception) {
+			Logger::log("Pipeline ", state.vertexShader, "/", state.fragmentShader,
+				" failed to compile, drawing with the fallback: ", exception.what());
+			entry->failed = true;
+			return {};
+		}
+	}
+
+	std::vector<vk::Pipeline> PipelineManager::evict(std::string const& shaderName) {
+		destroyAbandoned(false);
+		std::vector<vk::Pipeline> evicted;
+		for (auto entry = pipelines.begin(); entry != pipelines.end();) {
+			auto const& state = entry->second.state;
+			if (shaderName != state.vertexShader && shaderName != state.fragmentShader) {
+				++entry;
+				continue;
+			}
+			auto& pipeline = entry->second.pipeline;
+			if (pipeline.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				try {
+					evicted.push_back(pipeline.get());
+				} catch (std::exception const&) {
+					// Failed compiles left nothing to destroy
+				}
+			} else {
+				abandoned.push_back(pipeline);
+			}
+			entry = pipelines.erase(entry);
+		}
+		return evicted;
+	}
+
+	void PipelineManager::destroyAbandoned(bool wait) {
+		for (auto future = abandoned.begin(); future != abandoned.end();) {
+			if (!wait && future->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++future;
+				continue;
+			}
+			try {
+				device.destroyPipeline(future->get());
+			} catch (std::exception const& exception) {
+				Logger::log("Pipeline failed to compile: ", exception.what());
+			}
+			future = abandoned.erase(future);
+		}
+	}
+
+	PipelineManager::Entry* PipelineManager::find(PipelineState const& state, uint64_t key) {
+		auto entry = pipelines.find(key);
+		if (entry == pipelines.end()) {
+			return nullptr;
+		}
+		Logger::assertTrue(entry->second.state == state, "Pipeline state hash collision");
+		return &entry->second;
+	}
+
+	vk::Pipeline PipelineManager::compile(PipelineState const& state) {
+		auto compileStart = std::chrono::high_resolution_clock::now();
+		ScopedShader vertex(state.vertexShader, device, vk::ShaderStageFlagBits::eVertex);
+		ScopedShader fragment(state.fragmentShader, device, vk::ShaderStageFlagBits::eFragment);
+		auto& vertexShader = vertex.shader;
+		auto& fragmentShader = fragment.shader;
+
+		Specialization vertexSpecialization(state.vertexVariant);
+		Specialization fragmentSpecialization(state.fragmentVariant);
+		vk::PipelineShaderStageCreateInfo shaderStages[] = {
+			vertexShader.getShaderStageCreateInfo(vertexSpecialization.info()),
+			fragmentShader.getShaderStageCreateInfo(fragmentSpecialization.info())
+		};
+
+		auto vertexInput = describeVertexInput(state.vertexFormat);
+		for (auto const& input : vertexShader.getReflection().vertexInputs) {
+			bool provided = std::any_of(vertexInput.attributes.begin(), vertexInput.attributes.end(),
+				[&](vk::VertexInputAttributeDescription const& attribute) {
+					return attribute.location == input.location;
+				});
+			Logger::assertTrue(provided, std::string(state.vertexShader) + " reads vertex input location " +
+				std::to_string(input.location) + ", which the vertex format does not provide");
+		}
+		auto layout = layouts.pipelineLayout({&vertexShader.getReflection(), &fragmentShader.getReflection()});
+
+		vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{
+			{},
+			1u,
+			&vertexInput.binding,
+			static_cast<uint32_t>(vertexInput.attributes.size()),
+			vertexInput.attributes.data()
+		};
+
+		vk::PipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{
+			{},
+			vk::PrimitiveTopology::eTriangleList,
+			false
+		};
+
+		// Viewport and scissor are set while recording so the pipeline outlives swapchain resizes
+		vk::PipelineViewportStateCreateInfo viewportState{
+			{},
+			1,
+			nullptr,
+			1,
+			nullptr
+		};
+		std::array<vk::DynamicState, 2> dynamicStates{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+		vk::PipelineDynamicStateCreateInfo dynamicState{
+			{},
+			static_cast<uint32_t>(dynamicStates.size()),
+			dynamicStates.data()
+		};
+
+		vk::PipelineRasterizationStateCreateInfo rasterizer{{},
+			false,
+			false,
+			vk::PolygonMode::eFill,
+			state.cullMode,
+			vk::FrontFace::eCounterClockwise,
+			false,
+			0.0f,
+			0.0f,
+			0.0f,
+			1.0f
+		};
+
+		vk::PipelineMultisampleStateCreateInfo multisampleStateCreateInfo{
+			{},
+			state.samples,
+			true,
+			0.2f
+		};
+		vk::PipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{
+			{},
+			state.depthTest,
+			state.depthWrite,
+			vk::CompareOp::eLess,
+			false,
+			false
+		};
+
+		vk::ColorComponentFlags rgbaColorComponents = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+			vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+		vk::PipelineColorBlendAttachmentState colorBlendAttachment{
+			state.blend,
+			vk::BlendFactor::eSrcAlpha,
+			vk::BlendFactor::eOneMinusSrcAlpha,
+			vk::BlendOp::eAdd,
+			vk::BlendFactor::eOne,
+			vk::BlendFactor::eZero,
+			vk::BlendOp::eAdd,
+			rgbaColorComponents
+		};
+
+		vk::PipelineColorBlendStateCreateInfo colorBlendState{
+			{},
+			false,
+			vk::LogicOp::eCopy,
+			1u,
+			&colorBlendAttachment
+		};
+
+		vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
+			{},
+			2u,
+			shaderStages,
+			&vertexInputStateCreateInfo,
+			&pipelineInputAssemblyStateCreateInfo,
+			nullptr,
+			&viewportState,
+			&rasterizer,
+			&multisampleStateCreateInfo,
+			&depthStencilStateCreateInfo,
+			&colorBlendState,
+			&dynamicState,
+			layout,
+			renderPass,
+			0u
+		};
+
+		auto pipeline = device.createGraphicsPipeline(pipelineCreateInfo, cache);
+		auto compileEnd = std::chrono::high_resolution_clock::now();
+		Logger::log("Compiled pipeline ", state.vertexShader, "/", state.fragmentShader, " in ",
+			std::chrono::duration<float, std::chrono::milliseconds::period>(compileEnd - compileStart).count(), "ms");
+		return pipeline;
+	}
+}
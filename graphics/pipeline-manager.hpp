@@ -0,0 +1,95 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_MANAGER_HPP
+#define VULKAN_ENGINE_PIPELINE_MANAGER_HPP
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "device.hpp"
+#include "layout-cache.hpp"
+#include "vertex.hpp"
+#include "shader-variant.hpp"
+#include "../util/thread-pool.hpp"
+
+namespace Graphics {
+	/*
+	 * Everything a graphics pipeline is built from besides its layout and render pass. Zero-initialized including
+	 * padding and free of pointers, so the whole struct is hashed and compared byte for byte. The formats and sample
+	 * count stand in for the render pass: pipelines built for compatible render passes are interchangeable.
+	 */
+	struct PipelineState {
+		PipelineState();
+
+		// Shader names as found under shaders/, without the .spv extension
+		char vertexShader[32];
+		char fragmentShader[32];
+		// Each variant is a pipeline of its own, compiled when first requested
+		ShaderVariant vertexVariant;
+		ShaderVariant fragmentVariant;
+		VertexFormat vertexFormat;
+		vk::CullModeFlagBits cullMode;
+		vk::Bool32 depthTest;
+		vk::Bool32 depthWrite;
+		vk::Bool32 blend;
+		vk::Format colorFormat;
+		vk::Format depthFormat;
+		vk::SampleCountFlagBits samples;
+
+		void setShaders(std::string const& vertex, std::string const& fragment);
+		uint64_t hash() const;
+		bool operator==(PipelineState const& other) const;
+	};
+
+	/*
+	 * Owns every graphics pipeline, keyed by the hash of its PipelineState. get() compiles a missing pipeline on the
+	 * calling thread; request() hands it to the manager's own compile worker instead and returns a null handle until
+	 * it is ready, so callers draw with a fallback rather than stall the frame. The worker is separate from the
+	 * renderer's pool so a long compile never holds up parallel recording. A pipeline that failed to compile is
+	 * logged once and stays null until its shaders are evicted. Both are only called from one thread, compilation
+	 * itself goes through the internally synchronized pipeline and layout caches. Each pipeline's layout is the
+	 * shared one the layout cache builds from its reflected shaders.
+	 */
+	class PipelineManager {
+	public:
+		PipelineManager(Device& device, vk::PipelineCache cache, LayoutCache& layouts, vk::RenderPass renderPass);
+		~PipelineManager();
+		PipelineManager(PipelineManager const&) = delete;
+		PipelineManager& operator=(PipelineManager const&) = delete;
+
+		vk::Pipeline get(PipelineState const& state);
+		vk::Pipeline request(PipelineState const& state);
+		// Forgets every pipeline built from the shader and returns the finished ones, which the caller destroys once
+		// no frame in flight uses them. Pipelines still compiling are destroyed by the manager once they finish.
+		std::vector<vk::Pipeline> evict(std::string const& shaderName);
+	private:
+		struct Entry {
+			PipelineState state;
+			std::shared_future<vk::Pipeline> pipeline;
+			// Compilation threw, request() keeps returning a null handle instead of rethrowing every frame
+			bool failed = false;
+		};
+
+		Device& device;
+		vk::PipelineCache cache;
+		LayoutCache& layouts;
+		vk::RenderPass renderPass;
+		std::unordered_map<uint64_t, Entry> pipelines;
+		// Evicted while compiling and never handed out, destroyed on a later eviction or with the manager
+		std::vector<std::shared_future<vk::Pipeline>> abandoned;
+		// Declared last so its worker stops before anything a compile uses goes away
+		Util::ThreadPool compiler;
+
+		Entry* find(PipelineState const& state, uint64_t key);
+		vk::Pipeline compile(PipelineState const& state);
+		void destroyAbandoned(bool wait);
+	};
+}
+
+#endif //VULKAN_ENGINE_PIPELINE_MANAGER_HPP
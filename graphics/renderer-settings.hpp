@@ -0,0 +1,39 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_RENDERER_SETTINGS_HPP
+#define VULKAN_ENGINE_RENDERER_SETTINGS_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "mesh.hpp"
+#include "shader-variant.hpp"
+
+namespace Graphics {
+	struct RendererSettings {
+		// Render into an offscreen image ring instead of a window surface and swapchain
+		bool headless = false;
+		uint32_t width = 1820;
+		uint32_t height = 954;
+		// Number of frames to render in headless mode before stopping, 0 to render indefinitely
+		uint64_t frameLimit = 0;
+		// Processing applied to loaded models before upload
+		MeshOptions mesh{};
+		// Screen-space error in pixels a level of detail may introduce before a finer one is drawn
+		float lodErrorThreshold = 1.0f;
+		// Copies of the model drawn each frame, laid out on a grid
+		uint32_t objectCount = 1;
+		// Threads recording the draw list into secondary command buffers, 1 records inline on the render thread
+		uint32_t recordingThreads = 1;
+		// Format textures are cooked to, R8G8B8A8 is used instead when the device can not sample it
+		vk::Format textureFormat = vk::Format::eBc7UnormBlock;
+		// Fragment shader specialization the draw list uses, compiled in the background while the default draws
+		ShaderVariant fragmentVariant{};
+		// GLSL sources recompiled and hot reloaded whenever they change, empty to only load the prebuilt shaders
+		std::string shaderSourceDirectory;
+	};
+}
+
+#endif //VULKAN_ENGINE_RENDERER_SETTINGS_HPP
@@ -9,14 +9,11 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 
 #include "renderer.hpp"
 #include "../logger/logger.hpp"
@@ -24,55 +21,156 @@
 #include "../util/algorithm.hpp"
 #include "shader.hpp"
 #include "uniform-buffer-object.hpp"
+#include "mesh-cache.hpp"
+#include "meshlet.hpp"
+#include "obj-loader.hpp"
+#include "texture-cooker.hpp"
 
 namespace Graphics {
-	Renderer::Renderer(Core::Game& game): game(game), window(1820, 954, "Vulkan Engine"),
-										  presentMode(vk::PresentModeKHR::eFifo), depthFormat(vk::Format::eUndefined),
-										  ubo{} {
-		glfw::appendRequiredExtensions(instanceExtensions);
+	namespace {
+		float const fieldOfView = glm::radians(45.0f);
+		float const nearPlane = 0.1f;
+		float const farPlane = 10.0f;
+		// Room for everything a frame streams through the uniform ring, not just one UniformBufferObject
+		vk::DeviceSize const uniformRingPartitionSize = 64u * 1024u;
+		// Frames averaged into each report of the command recording cost
+		uint32_t const recordingReportInterval = 1000u;
+	}
+
+	Renderer::Renderer(Core::Game& game, RendererSettings settings): game(game), settings(settings),
+																	presentMode(vk::PresentModeKHR::eFifo),
+																	depthFormat(vk::Format::eUndefined), ubo{} {
+		if (!settings.headless) {
+			window.emplace(static_cast<int>(settings.width), static_cast<int>(settings.height), "Vulkan Engine");
+			instanceExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+			glfw::appendRequiredExtensions(instanceExtensions);
+			deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		}
 		setupValidationLayers(instanceExtensions, validationLayers);
 		createInstance();
-		surface = window.createSurface(instance);
+		if (window) {
+			surface = window->createSurface(instance);
+		}
 		choosePhysicalDevice();
 		device->createLogicalDevice(deviceExtensions, validationLayers);
 		allocator = device->createAllocator();
-		createCommandPool();
+		timeline.emplace(*device);
+		pipelineCache.emplace(*device, "cache/pipeline-cache.bin");
+		layouts.emplace(*device);
+		if (!device->supportsTimelineSemaphores()) {
+			Logger::log("Device does not support timeline semaphores, falling back to fences");
+		}
+		createCommandPools();
+		uploads.emplace(*device, allocator, *timeline);
 		createTextureImage();
 		createTextureSampler();
 		createSynchronization();
 
 		loadModel();
+		meshletCulling = !mesh.meshlets().empty() && device->supportsMultiDrawIndirect();
+		if (!mesh.meshlets().empty() && !meshletCulling) {
+			Logger::log("Device does not support multiDrawIndirect, meshlet culling disabled");
+		}
 		createVertexBuffer();
 		createIndexBuffer();
-		createDescriptorSetLayout();
+		mesh.release();
+		createDrawCommandRings();
+		createPipelineLayout();
+		chooseFormats();
+		createRenderPass();
+		createUniformRing();
+		createDescriptorSets();
+		createGraphicsPipeline();
 		createSwapchainAndFriends();
+		if (!settings.shaderSourceDirectory.empty()) {
+			shaderReloader.emplace(settings.shaderSourceDirectory);
+		}
+		// All initial assets and layout transitions go to the GPU in a single submission
+		uploads->flush();
 	}
 
-	void Renderer::createSwapchainAndFriends() {
-		surfaceFormat = chooseSurfaceFormat(device->getSurfaceFormats());
-		presentMode = choosePresentMode(device->getPresentModes());
-		extent = chooseExtent(device->getCapabilities());
-		createSwapchain();
+	Renderer::~Renderer() {
+		// Windowed frames may still be running, nothing they use can go before the device is idle
+		if (device) {
+			device->waitUntilIdle();
+		}
+		if (!pipelineCache) {
+			return;
+		}
+		// Waits for pipelines still compiling so they make it into the saved cache
+		pipelines.reset();
+		// Losing the cache only costs compile time on the next launch, so it must not throw out of here
+		try {
+			pipelineCache->save();
+		} catch (std::exception const& exception) {
+			Logger::log("Failed to save the pipeline cache: ", exception.what());
+		}
+	}
+
+	// Formats the render pass and pipeline are built for, kept for the renderer's lifetime
+	void Renderer::chooseFormats() {
+		if (settings.headless) {
+			surfaceFormat = vk::SurfaceFormatKHR{vk::Format::eB8G8R8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear};
+		} else {
+			surfaceFormat = chooseSurfaceFormat(device->getSurfaceFormats());
+			presentMode = choosePresentMode(device->getPresentModes());
+		}
+		depthFormat = chooseSupportedFormat({vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint},
+			vk::ImageTiling::eOptimal, vk::FormatFeatureFlagBits::eDepthStencilAttachment);
+	}
+
+	// Only what depends on the extent, render pass, pipeline and descriptors survive resizes
+	void Renderer::createSwapchainAndFriends(vk::SwapchainKHR oldSwapchain) {
+		if (settings.headless) {
+			extent = vk::Extent2D{settings.width, settings.height};
+			createOffscreenImages();
+		} else {
+			extent = chooseExtent(device->getCapabilities());
+			createSwapchain(oldSwapchain);
+		}
 		createColorImage();
 		createDepthImage();
-		createRenderPass();
 		createFramebuffers();
-		createUniformBuffers();
-		createDescriptorPool();
-		createDescriptorSets();
-		createGraphicsPipeline();
-		createCommandBuffers();
 	}
 
 	void Renderer::recreateSwapchain() {
-		device->waitUntilIdle();
+		// A minimized window has no area to present to, run() retries until it has one again
+		auto nextExtent = chooseExtent(device->getCapabilities());
+		swapchainOutdated = nextExtent.width == 0u || nextExtent.height == 0u;
+		if (swapchainOutdated) {
+			return;
+		}
+
+		// Only the frames in flight can still use the framebuffers and attachments
+		for (auto point : framePoints) {
+			timeline->wait(point);
+		}
+		auto resizeStart = std::chrono::high_resolution_clock::now();
+		auto oldSwapchain = swapchain;
 		destroySwapchainAndFriends();
-		createSwapchainAndFriends();
+		createSwapchainAndFriends(oldSwapchain);
+		// Its last presents may still be pending, see retireSwapchains
+		retiredSwapchains.push_back({oldSwapchain, static_cast<uint32_t>(maxFrames)});
+		uploads->flush();
+		auto resizeEnd = std::chrono::high_resolution_clock::now();
+		Logger::log("Resized swapchain to ", extent.width, "x", extent.height, " in ",
+			std::chrono::duration<float, std::chrono::milliseconds::period>(resizeEnd - resizeStart).count(), "ms");
 	}
 
 	void Renderer::run() {
+		if (settings.headless) {
+			renderOffscreen();
+			return;
+		}
+
 		glfw::tick();
-		device->waitForFence(commandBufferFences[currentFrame]);
+		if (swapchainOutdated) {
+			recreateSwapchain();
+			return;
+		}
+		timeline->wait(framePoints[currentFrame]);
+		timeline->collect();
+		uploads->collect();
 		vk::ResultValue<uint32_t> imageAcquisition(vk::Result::eSuccess, 0u);
 		try {
 			imageAcquisition = device->acquireNextImage(swapchain, imageAvailableSemaphores[currentFrame]);
@@ -88,18 +186,21 @@ namespace Graphics {
 			throw Logger::error("Swapchain image acquisition unsuccessful");
 		}
 		vk::PipelineStageFlags temp = vk::PipelineStageFlagBits::eVertexInput;
-		updateUniformBuffer(imageAcquisition.value);
+		updateDrawList();
+		updateUniformBuffer();
+		updateDrawCommands();
+		recordCommandBuffer(imageAcquisition.value);
 		vk::SubmitInfo submitInfo{
 			1u,
 			&(imageAvailableSemaphores[currentFrame]),
 			&temp,
 			1u,
-			&(commandBuffers[imageAcquisition.value]),
+			&(commandBuffers[currentFrame]),
 			1u,
 			&(renderFinishedSemaphores[currentFrame])
 		};
-		device->resetFence(commandBufferFences[currentFrame]);
-		device->graphicsQueue.submit(1u, &submitInfo, commandBufferFences[currentFrame]);
+		framePoints[currentFrame] = timeline->submit(submitInfo);
+		retireSwapchains();
 
 		try {
 			auto result = device->presentQueue.presentKHR({
@@ -111,8 +212,8 @@ namespace Graphics {
 				nullptr
 			});
 
-			if (window.shouldResize() || result == vk::Result::eSuboptimalKHR) {
-				window.handleResize();
+			if (window->shouldResize() || result == vk::Result::eSuboptimalKHR) {
+				window->handleResize();
 				throw vk::OutOfDateKHRError("Swapchain recreation required");
 			}
 		} catch (vk::OutOfDateKHRError& _) {
@@ -122,12 +223,54 @@ namespace Graphics {
 		currentFrame = (currentFrame + 1) % maxFrames;
 	}
 
+	// Offscreen frames render into the image ring slot of the current frame, so there is nothing to acquire or present
+	void Renderer::renderOffscreen() {
+		if (!offscreenStart) {
+			offscreenStart = std::chrono::high_resolution_clock::now();
+		}
+		timeline->wait(framePoints[currentFrame]);
+		timeline->collect();
+		uploads->collect();
+		auto imageIndex = static_cast<uint32_t>(currentFrame);
+		updateDrawList();
+		updateUniformBuffer();
+		updateDrawCommands();
+		recordCommandBuffer(imageIndex);
+		vk::SubmitInfo submitInfo{
+			0u,
+			nullptr,
+			nullptr,
+			1u,
+			&(commandBuffers[currentFrame])
+		};
+		framePoints[currentFrame] = timeline->submit(submitInfo);
+
+		++framesRendered;
+		if (framesRendered == settings.frameLimit) {
+			device->waitUntilIdle();
+			auto currentTime = std::chrono::high_resolution_clock::now();
+			float time = std::chrono::duration<float, std::chrono::milliseconds::period>(
+				currentTime - *offscreenStart).count();
+			Logger::log("Rendered ", framesRendered, " offscreen frames in ", time, "ms (",
+				static_cast<float>(framesRendered) * 1000.0f / time, " fps)");
+			reportRecordingCost();
+		}
+
+		currentFrame = (currentFrame + 1) % maxFrames;
+	}
+
 	bool Renderer::shouldContinue() {
-		return !window.shouldClose();
+		if (settings.headless) {
+			return settings.frameLimit == 0 || framesRendered < settings.frameLimit;
+		}
+		return !window->shouldClose();
 	}
 
 	void Renderer::createInstance() {
 		auto appInfo = game.makeAppInfo();
+		// Vulkan 1.2 brings timeline semaphores, older loaders get what they support and devices use fences
+		apiVersion = std::min(vk::enumerateInstanceVersion(), static_cast<uint32_t>(VK_API_VERSION_1_2));
+		appInfo.apiVersion = apiVersion;
 		vk::InstanceCreateInfo createInfo{
 			{},
 			&appInfo,
@@ -147,7 +290,7 @@ namespace Graphics {
 
 		devices.reserve(physicalDevices.size());
 		for (auto& physicalDevice : physicalDevices) {
-			devices.emplace_back(physicalDevice, surface, deviceExtensions);
+			devices.emplace_back(physicalDevice, surface, deviceExtensions, apiVersion);
 		}
 
 		auto best = std::max_element(begin(devices), end(devices));
@@ -158,72 +301,153 @@ namespace Graphics {
 
 	void Renderer::createSynchronization() {
 		vk::SemaphoreCreateInfo semaphoreCreateInfo{};
-		vk::FenceCreateInfo fenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
 
 		imageAvailableSemaphores.reserve(maxFrames);
 		renderFinishedSemaphores.reserve(maxFrames);
-		commandBufferFences.reserve(maxFrames);
 		for (int i = 0; i < maxFrames; ++i) {
 			imageAvailableSemaphores.push_back(device->createSemaphore(semaphoreCreateInfo));
 			renderFinishedSemaphores.push_back(device->createSemaphore(semaphoreCreateInfo));
-			commandBufferFences.push_back(device->createFence(fenceCreateInfo));
 		}
+		// Point 0 is complete before anything was submitted
+		framePoints.assign(maxFrames, 0u);
 	}
 
-	void Renderer::createCommandPool() {
-		commandPool = device->createCommandPool({
-			vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-			device->graphicsIndex()
-		});
-
+	void Renderer::createCommandPools() {
+		if (settings.recordingThreads > 1u) {
+			recorder.emplace(*device, threadPool, static_cast<uint32_t>(maxFrames), settings.recordingThreads);
+		}
+		commandPools.reserve(maxFrames);
+		commandBuffers.reserve(maxFrames);
+		for (int i = 0; i < maxFrames; ++i) {
+			commandPools.push_back(device->createCommandPool({
+				vk::CommandPoolCreateFlagBits::eTransient,
+				device->graphicsIndex()
+			}));
+			commandBuffers.push_back(device->allocateCommandBuffers({
+				commandPools.back(),
+				vk::CommandBufferLevel::ePrimary,
+				1u
+			})[0]);
+		}
 	}
 
-	void Renderer::createCommandBuffers() {
-		commandBuffers = device->allocateCommandBuffers({
-			commandPool,
-			vk::CommandBufferLevel::ePrimary,
-			maxFrames
-		});
+	// Re-recorded every frame so per-draw push constants can change
+	void Renderer::recordCommandBuffer(uint32_t imageIndex) {
+		auto recordingStart = std::chrono::high_resolution_clock::now();
+		reloadShaders();
+		resolveMaterialPipelines();
+		// The frame that last recorded into this pool finished, its timeline point was waited for
+		device->resetCommandPool(commandPools[currentFrame]);
+		descriptors->resetFrame(static_cast<uint32_t>(currentFrame));
+		auto& commandBuffer = commandBuffers[currentFrame];
+		commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+		{
+			std::array<vk::ClearValue, 2> clearValues = {
+				Util::makeClearColor(0.0f, 0.0f, 0.0f),
+				Util::makeClearDepthStencil(1.0f, 0u)
+			};
+			vk::RenderPassBeginInfo renderPassBeginInfo{
+				renderPass,
+				framebuffers[imageIndex],
+				{{0, 0}, extent},
+				static_cast<uint32_t>(clearValues.size()),
+				clearValues.data()
+			};
 
-		vk::CommandBufferBeginInfo beginInfo{};
+			// Secondary command buffers recorded on the workers, or the draws inline when recording serially
+			if (recorder && !drawList.empty()) {
+				commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+				auto const& secondaryCommandBuffers = recorder->record(static_cast<uint32_t>(currentFrame),
+					renderPass, framebuffers[imageIndex], drawList.size(),
+					[this](vk::CommandBuffer secondaryCommandBuffer, size_t first, size_t end) {
+						recordDraws(secondaryCommandBuffer, first, end);
+					});
+				commandBuffer.executeCommands(secondaryCommandBuffers);
+			} else {
+				commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+				recordDraws(commandBuffer, 0u, drawList.size());
+			}
+			commandBuffer.endRenderPass();
+		}
+		commandBuffer.end();
 
-		for (int i = 0; i < maxFrames; i++) {
-			auto& commandBuffer = commandBuffers[i];
-			commandBuffer.begin(&beginInfo);
-			{
-				std::array<vk::ClearValue, 2> clearValues = {
-					Util::makeClearColor(0.0f, 0.0f, 0.0f),
-					Util::makeClearDepthStencil(1.0f, 0u)
-				};
-				vk::RenderPassBeginInfo renderPassBeginInfo{
-					renderPass,
-					framebuffers[i],
-					{{0, 0}, extent},
-					static_cast<uint32_t>(clearValues.size()),
-					clearValues.data()
-				};
+		auto recordingEnd = std::chrono::high_resolution_clock::now();
+		auto elapsed = std::chrono::duration<float, std::chrono::milliseconds::period>(
+			recordingEnd - recordingStart).count();
+		recordingMilliseconds += elapsed;
+		totalRecordingMilliseconds += elapsed;
+		++totalRecordedFrames;
+		if (++recordedFrames == recordingReportInterval) {
+			reportRecordingCost();
+		}
+	}
 
-				commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-				{
-					commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, graphicsPipeline);
-
-					vk::Buffer vertexBuffers[] = {vertexBuffer};
-					vk::DeviceSize offsets[] = {0u};
-					commandBuffer.bindVertexBuffers(0u, 1u, vertexBuffers, offsets);
-					commandBuffer.bindIndexBuffer(indexBuffer, 0u, vk::IndexType::eUint32);
-					commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout,
-						0u, 1u, &descriptorSets[i], 0u, nullptr);
-					commandBuffer.drawIndexed(
-						static_cast<uint32_t>(indices.size()),
-						1u, 0u, 0u, 0u);
+	// Records drawList[first, end), binding all state itself since secondary command buffers inherit none.
+	// Only reads renderer state, so it may run on several threads at once.
+	void Renderer::recordDraws(vk::CommandBuffer commandBuffer, size_t first, size_t end) {
+		vk::Buffer vertexBuffers[] = {vertexBuffer};
+		vk::DeviceSize offsets[] = {0u};
+		commandBuffer.bindVertexBuffers(0u, 1u, vertexBuffers, offsets);
+		commandBuffer.bindIndexBuffer(indexBuffer, 0u, mesh.indexType());
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout,
+			0u, 1u, &descriptorSet, 1u, &uniformOffset);
+		vk::Viewport viewport{
+			0.0f,
+			0.0f,
+			static_cast<float>(extent.width),
+			static_cast<float>(extent.height),
+			0.0f,
+			1.0f
+		};
+		vk::Rect2D scissor{{0, 0}, extent};
+		commandBuffer.setViewport(0u, 1u, &viewport);
+		commandBuffer.setScissor(0u, 1u, &scissor);
+		uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+		vk::Buffer drawCommandBuffer = drawCommandRings[currentFrame];
+		bool multiDrawIndirect = device->supportsMultiDrawIndirect();
+		// Every pipeline shares pipelineLayout, so descriptors and push constants survive rebinding
+		vk::Pipeline boundPipeline;
+		for (size_t draw = first; draw < end; ++draw) {
+			auto const& entry = drawList[draw];
+			// Entirely culled, see updateDrawCommands
+			if (entry.commandCount == 0u) {
+				continue;
+			}
+			auto pipeline = materialPipelines[entry.material];
+			if (pipeline != boundPipeline) {
+				commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+				boundPipeline = pipeline;
+			}
+			commandBuffer.pushConstants(pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0u,
+				sizeof(DrawConstants), &entry.constants);
+			vk::DeviceSize firstCommand = entry.firstCommand;
+			if (multiDrawIndirect) {
+				commandBuffer.drawIndexedIndirect(drawCommandBuffer, firstCommand * stride, entry.commandCount, stride);
+			} else {
+				for (uint32_t command = 0; command < entry.commandCount; ++command) {
+					commandBuffer.drawIndexedIndirect(drawCommandBuffer, (firstCommand + command) * stride, 1u,
+						stride);
 				}
-				commandBuffer.endRenderPass();
 			}
-			commandBuffer.end();
 		}
 	}
 
-	void Renderer::createSwapchain() {
+	float Renderer::averageRecordingMilliseconds() const {
+		return totalRecordedFrames == 0u ? 0.0f :
+			static_cast<float>(totalRecordingMilliseconds / static_cast<double>(totalRecordedFrames));
+	}
+
+	void Renderer::reportRecordingCost() {
+		if (recordedFrames == 0u) {
+			return;
+		}
+		Logger::log("Recorded ", drawList.size(), " draws in ", recordingMilliseconds / recordedFrames,
+			"ms per frame on average over ", recordedFrames, " frames");
+		recordingMilliseconds = 0.0f;
+		recordedFrames = 0u;
+	}
+
+	void Renderer::createSwapchain(vk::SwapchainKHR oldSwapchain) {
 		uint32_t queueIndices[] = {device->graphicsIndex(), device->presentIndex()};
 		bool queuesSame = queueIndices[0] == queueIndices[1];
 
@@ -246,12 +470,24 @@ namespace Graphics {
 			queueIndices,
 			device->getCapabilities().currentTransform,
 			vk::CompositeAlphaFlagBitsKHR::eOpaque,
-			presentMode
+			presentMode,
+			false,
+			oldSwapchain
 		});
 
 		images = device->getSwapchainImages(swapchain, surfaceFormat.format);
 	}
 
+	void Renderer::createOffscreenImages() {
+		images.reserve(maxFrames);
+		for (int i = 0; i < maxFrames; ++i) {
+			images.emplace_back(allocator, device, extent.width, extent.height, 1u, surfaceFormat.format,
+				vk::ImageTiling::eOptimal,
+				vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+				vk::ImageAspectFlagBits::eColor, vk::SampleCountFlagBits::e1, vma::MemoryUsage::eGpuOnly);
+		}
+	}
+
 	vk::SurfaceFormatKHR Renderer::chooseSurfaceFormat(std::vector<vk::SurfaceFormatKHR> const& supportedFormats) {
 		if (supportedFormats.size() == 1 && supportedFormats[0].format == vk::Format::eUndefined) {
 			return {
@@ -279,12 +515,27 @@ namespace Graphics {
 		return vk::PresentModeKHR::eFifo;
 	}
 
+	// No timeline point covers presentation, so an old swapchain is only released after maxFrames frames were
+	// submitted to its successor; by the time the last of those completes its own presents are long finished
+	void Renderer::retireSwapchains() {
+		for (auto retired = retiredSwapchains.begin(); retired != retiredSwapchains.end();) {
+			if (--retired->framesLeft > 0u) {
+				++retired;
+				continue;
+			}
+			timeline->release([device = device, swapchain = retired->swapchain]() {
+				device->destroySwapchain(swapchain);
+			});
+			retired = retiredSwapchains.erase(retired);
+		}
+	}
+
 	vk::Extent2D Renderer::chooseExtent(vk::SurfaceCapabilitiesKHR const& capabilities) {
 		if (capabilities.currentExtent.width != UINT32_MAX) {
 			return capabilities.currentExtent;
 		}
 
-		auto windowExtent = window.getFramebufferSize();
+		auto windowExtent = window->getFramebufferSize();
 		windowExtent.width = Util::clamp(windowExtent.width, capabilities.minImageExtent.width,
 			capabilities.maxImageExtent.width);
 		windowExtent.height = Util::clamp(windowExtent.height, capabilities.minImageExtent.height,
@@ -293,14 +544,6 @@ namespace Graphics {
 	}
 
 	void Renderer::createDepthImage() {
-		std::vector<vk::Format> formats{
-			vk::Format::eD32SfloatS8Uint,
-			vk::Format::eD24UnormS8Uint
-		};
-
-		depthFormat = chooseSupportedFormat(formats, vk::ImageTiling::eOptimal,
-			vk::FormatFeatureFlagBits::eDepthStencilAttachment);
-
 		// Aspect Mask always has depth bit, only has stencil bit if supported by format
 		vk::ImageAspectFlags aspectMask = Util::doesFormatSupportStencil(depthFormat)
 										  ? vk::ImageAspectFlagBits::eDepth
@@ -359,7 +602,9 @@ namespace Graphics {
 				vk::AttachmentLoadOp::eDontCare,
 				vk::AttachmentStoreOp::eDontCare,
 				vk::ImageLayout::eUndefined,
-				vk::ImageLayout::ePresentSrcKHR
+				settings.headless
+				? vk::ImageLayout::eTransferSrcOptimal
+				: vk::ImageLayout::ePresentSrcKHR
 			}
 		};
 
@@ -422,362 +667,358 @@ namespace Graphics {
 	}
 
 	void Renderer::createTextureImage() {
-		int width, height, channels;
-		stbi_uc* pixels = stbi_load("../assets/textures/chalet.jpg", &width, &height, &channels, STBI_rgb_alpha);
-		vk::DeviceSize imageSize = width * height * 4;
+		// Fall back to uncompressed texels where the device can not sample the requested block format
+		auto format = chooseSupportedFormat({settings.textureFormat, vk::Format::eR8G8B8A8Unorm}, vk::ImageTiling::eOptimal,
+			vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear);
+		auto texture = loadTexture("../assets/textures/chalet.jpg", format);
+		mipLevels = texture.levelCount();
+
+		textureImage = Image(allocator, device, texture.width(), texture.height(), mipLevels, texture.format(),
+			vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+			vk::ImageAspectFlagBits::eColor, vk::SampleCountFlagBits::e1, vma::MemoryUsage::eGpuOnly);
 
-		if (!pixels) {
-			throw Logger::error("Failed to load image");
+		// Every level comes from the cooked texture, one region each
+		std::vector<vk::BufferImageCopy> regions;
+		for (uint32_t level = 0; level < mipLevels; ++level) {
+			auto const& textureLevel = texture.levels()[level];
+			regions.push_back({
+				textureLevel.offset, 0u, 0u,
+				{vk::ImageAspectFlagBits::eColor, level, 0u, 1u},
+				{0u, 0u, 0u},
+				{textureLevel.width, textureLevel.height, 1u}
+			});
 		}
-		mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
-
-		auto stagingBuffer = Buffer(allocator, imageSize, vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			vma::MemoryUsage::eCpuToGpu);
-
-		copyMemory(stagingBuffer, pixels, static_cast<size_t>(imageSize));
 
-		stbi_image_free(pixels);
+		uploads->uploadImage(texture.data(), texture.dataSize(), textureImage, mipLevels, regions);
+	}
 
-		textureImage = Image(allocator, device, static_cast<uint32_t>(width), static_cast<uint32_t>(height), mipLevels,
-			vk::Format::eR8G8B8A8Unorm, vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled |
-				vk::ImageUsageFlagBits::eTransferSrc,
-			vk::ImageAspectFlagBits::eColor, vk::SampleCountFlagBits::e1, vma::MemoryUsage::eGpuOnly);
+	Texture Renderer::loadTexture(std::string const& path, vk::Format format) {
+		// Cooked textures are rebuilt whenever the source image is newer or the format changed
+		auto cookedPath = (std::filesystem::path("cache") / std::filesystem::path(path).filename()).string() + ".ktx2";
+		std::error_code error;
+		if (std::filesystem::exists(cookedPath, error) &&
+			(!std::filesystem::exists(path, error) ||
+			 std::filesystem::last_write_time(cookedPath) >= std::filesystem::last_write_time(path))) {
+			auto cooked = Texture::loadKtx2(cookedPath);
+			if (cooked && cooked->format() == format) {
+				return std::move(*cooked);
+			}
+		}
 
-		transitionImageLayout(textureImage, vk::Format::eR8G8B8A8Unorm, mipLevels, vk::ImageLayout::eUndefined,
-			vk::ImageLayout::eTransferDstOptimal);
-		copyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
-		generateMipmaps(textureImage, width, height);
+		auto texture = cookTexture(path, format, threadPool);
+		texture.writeKtx2(cookedPath);
+		return texture;
 	}
 
 	void Renderer::createGraphicsPipeline() {
-		auto vertexShader = Shader("vertex", device, vk::ShaderStageFlagBits::eVertex);
-		auto fragmentShader = Shader("fragment", device, vk::ShaderStageFlagBits::eFragment);
-
-		vk::PipelineShaderStageCreateInfo shaderStages[] = {
-			vertexShader.getShaderStageCreateInfo(),
-			fragmentShader.getShaderStageCreateInfo()
-		};
-
-		auto bindingDescription = Vertex::getBindingDescription();
-		auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
-		vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{
-			{},
-			1u,
-			&bindingDescription,
-			static_cast<uint32_t>(attributeDescriptions.size()),
-			attributeDescriptions.data()
-		};
-
-		vk::PipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{
-			{},
-			vk::PrimitiveTopology::eTriangleList,
-			false
-		};
-
-		vk::Viewport viewport{
-			0.0f,
-			0.0f,
-			static_cast<float>(extent.width),
-			static_cast<float>(extent.height),
-			0.0f,
-			1.0f
-		};
-
-		vk::Rect2D scissor = {{0, 0}, extent};
-
-		vk::PipelineViewportStateCreateInfo viewportState{
-			{},
-			1,
-			&viewport,
-			1,
-			&scissor
-		};
-
-		vk::PipelineRasterizationStateCreateInfo rasterizer{{},
-			false,
-			false,
-			vk::PolygonMode::eFill,
-			vk::CullModeFlagBits::eBack,
-			vk::FrontFace::eCounterClockwise,
-			false,
-			0.0f,
-			0.0f,
-			0.0f,
-			1.0f
-		};
+		pipelines.emplace(*device, *pipelineCache, *layouts, renderPass);
+
+		PipelineState defaultState;
+		defaultState.setShaders(vertexShaderName(), "fragment");
+		defaultState.vertexFormat = mesh.vertexFormat();
+		defaultState.colorFormat = surfaceFormat.format;
+		defaultState.depthFormat = depthFormat;
+		defaultState.samples = device->getSamples();
+		materials = {defaultState};
+		if (!settings.fragmentVariant.empty()) {
+			auto variantState = defaultState;
+			variantState.fragmentVariant = settings.fragmentVariant;
+			materials.push_back(variantState);
+		}
 
-		vk::PipelineMultisampleStateCreateInfo multisampleStateCreateInfo{
-			{},
-			device->getSamples(),
-			true,
-			0.2f
-		};
-		vk::PipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{
-			{},
-			true,
-			true,
-			vk::CompareOp::eLess,
-			false,
-			false
-		};
+		auto compileStart = std::chrono::high_resolution_clock::now();
+		graphicsPipeline = pipelines->get(defaultState);
+		auto compileEnd = std::chrono::high_resolution_clock::now();
+		Logger::log("Created graphics pipeline in ",
+			std::chrono::duration<float, std::chrono::milliseconds::period>(compileEnd - compileStart).count(), "ms (",
+			pipelineCache->isWarm() ? "warm" : "cold", " pipeline cache)");
+	}
 
-		vk::ColorComponentFlags rgbaColorComponents = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-			vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+	// Materials whose pipeline is still compiling draw with the default pipeline, never waiting for the workers
+	void Renderer::resolveMaterialPipelines() {
+		materialPipelines.resize(materials.size());
+		for (size_t material = 0; material < materials.size(); ++material) {
+			auto pipeline = pipelines->request(materials[material]);
+			// Only differs after the default material's shaders were reloaded and its new pipeline finished
+			if (material == 0u && pipeline && pipeline != graphicsPipeline) {
+				retirePipelines({graphicsPipeline});
+				graphicsPipeline = pipeline;
+			}
+			materialPipelines[material] = pipeline ? pipeline : graphicsPipeline;
+		}
+	}
 
-		vk::PipelineColorBlendAttachmentState colorBlendAttachment{
-			false,
-			vk::BlendFactor::eOne,
-			vk::BlendFactor::eZero,
-			vk::BlendOp::eAdd,
-			vk::BlendFactor::eOne,
-			vk::BlendFactor::eZero,
-			vk::BlendOp::eAdd,
-			rgbaColorComponents
-		};
+	// Runs between frames: pipelines using recompiled shaders are rebuilt in the background and swapped in by
+	// resolveMaterialPipelines once ready, the default pipeline keeps serving as the fallback until then
+	void Renderer::reloadShaders() {
+		if (!shaderReloader) {
+			return;
+		}
+		for (auto const& shaderName : shaderReloader->takeReloaded()) {
+			if (!keepsPipelineLayout(shaderName)) {
+				continue;
+			}
+			auto evicted = pipelines->evict(shaderName);
+			evicted.erase(std::remove(evicted.begin(), evicted.end(), graphicsPipeline), evicted.end());
+			retirePipelines(std::move(evicted));
+		}
+	}
 
-		vk::PipelineColorBlendStateCreateInfo colorBlendState{
-			{},
-			false,
-			vk::LogicOp::eCopy,
-			1u,
-			&colorBlendAttachment
-		};
+	// Every material is recorded against pipelineLayout with DrawConstants as push constants, so a reloaded shader
+	// whose interface no longer matches is refused and the pipelines built from its previous code stay in use
+	bool Renderer::keepsPipelineLayout(std::string const& shaderName) {
+		if (shaderName != vertexShaderName() && shaderName != "fragment") {
+			return true;
+		}
+		try {
+			auto vertexShader = Shader::reflect(vertexShaderName(), vk::ShaderStageFlagBits::eVertex);
+			auto fragmentShader = Shader::reflect("fragment", vk::ShaderStageFlagBits::eFragment);
+			bool pushConstantsMatch = vertexShader.pushConstants &&
+				vertexShader.pushConstants->size == sizeof(DrawConstants);
+			if (pushConstantsMatch && layouts->pipelineLayout({&vertexShader, &fragmentShader}) == pipelineLayout) {
+				return true;
+			}
+			Logger::log("Reloaded ", shaderName, " shader changed its interface, keeping the previous pipelines");
+		} catch (std::exception const& exception) {
+			Logger::log("Failed to reflect reloaded ", shaderName, " shader, keeping the previous pipelines: ",
+				exception.what());
+		}
+		return false;
+	}
 
-		pipelineLayout = device->createPipelineLayout({
-			{},
-			1u,
-			&descriptorSetLayout
-			// TODO: Push constants
+	// Frames in flight may still draw with the pipelines, they go once everything submitted so far finished
+	void Renderer::retirePipelines(std::vector<vk::Pipeline> retired) {
+		if (retired.empty()) {
+			return;
+		}
+		timeline->release([device = device, retired = std::move(retired)]() {
+			for (auto pipeline : retired) {
+				device->destroyPipeline(pipeline);
+			}
 		});
-
-		vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
-			{},
-			2u,
-			shaderStages,
-			&vertexInputStateCreateInfo,
-			&pipelineInputAssemblyStateCreateInfo,
-			nullptr,
-			&viewportState,
-			&rasterizer,
-			&multisampleStateCreateInfo,
-			&depthStencilStateCreateInfo,
-			&colorBlendState,
-			nullptr,
-			pipelineLayout,
-			renderPass,
-			0u
-		};
-
-		graphicsPipeline = device->createGraphicsPipeline(pipelineCreateInfo);
 	}
 
 	void Renderer::destroySwapchainAndFriends() {
-		device->destroySwapchain(swapchain, framebuffers, commandPool, commandBuffers, graphicsPipeline,
-			renderPass, images, descriptorPool);
-		for (auto& uniformBuffer : uniformBuffers) {
-			allocator.freeMemory(uniformBuffer);
+		device->destroyFramebuffers(framebuffers);
+		framebuffers.clear();
+		colorImage.destroy(allocator, *device);
+		depthImage.destroy(allocator, *device);
+		for (auto& image : images) {
+			image.destroy(allocator, *device);
 		}
-		uniformBuffers.clear();
+		images.clear();
 	}
 
 	void Renderer::createVertexBuffer() {
-		vk::DeviceSize const size = sizeof(vertices[0]) * vertices.size();
-		Buffer stagingBuffer(allocator, size,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			vma::MemoryUsage::eCpuToGpu);
-
+		vk::DeviceSize const size = mesh.vertexDataSize();
 		vertexBuffer = Buffer(allocator, size,
 			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
 			vk::MemoryPropertyFlagBits::eDeviceLocal,
 			vma::MemoryUsage::eGpuOnly);
 
-		copyMemory(stagingBuffer, vertices.data(), sizeof(vertices[0]) * vertices.size());
-
-		copyBuffer(stagingBuffer, vertexBuffer, size);
+		uploads->uploadBuffer(mesh.vertexData(), size, vertexBuffer, vk::AccessFlagBits::eVertexAttributeRead,
+			vk::PipelineStageFlagBits::eVertexInput);
 	}
 
 	void Renderer::createIndexBuffer() {
-		vk::DeviceSize size = sizeof(indices[0]) * indices.size();
-
-		Buffer stagingBuffer(allocator, size,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			vma::MemoryUsage::eCpuToGpu);
-
-		copyMemory(stagingBuffer, indices.data(), sizeof(indices[0]) * indices.size());
-
+		vk::DeviceSize size = mesh.indexDataSize();
 		indexBuffer = Buffer(allocator, size,
 			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
 			vk::MemoryPropertyFlagBits::eDeviceLocal, vma::MemoryUsage::eGpuOnly);
 
-		copyBuffer(stagingBuffer, indexBuffer, size);
+		uploads->uploadBuffer(mesh.indexData(), size, indexBuffer, vk::AccessFlagBits::eIndexRead,
+			vk::PipelineStageFlagBits::eVertexInput);
 	}
 
-	void Renderer::createUniformBuffers() {
-		vk::DeviceSize size = sizeof(UniformBufferObject);
+	void Renderer::createUniformRing() {
+		uniformRing = RingBuffer(allocator, vk::BufferUsageFlagBits::eUniformBuffer, uniformRingPartitionSize,
+			static_cast<uint32_t>(maxFrames), device->minUniformBufferOffsetAlignment());
+	}
 
-		uniformBuffers.resize(images.size());
-		for (size_t i = 0; i < images.size(); ++i) {
-			uniformBuffers[i] = Buffer(allocator, size, vk::BufferUsageFlagBits::eUniformBuffer,
-				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-				vma::MemoryUsage::eCpuToGpu);
-		}
+	// One draw per meshlet when culling them, otherwise one per submesh
+	uint32_t Renderer::lodCommandCount(MeshLod const& lod) const {
+		return meshletCulling ? lod.meshletCount : lod.submeshCount;
 	}
 
-	void Renderer::copyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size) {
-		runCommand([&](vk::CommandBuffer const& commandBuffer) {
-			vk::BufferCopy copyRegion{0, 0, size};
-			commandBuffer.copyBuffer(src, dst, 1u, &copyRegion);
-		});
+	// Created by updateDrawCommands once the draw list is known and grown whenever it outgrows them
+	void Renderer::createDrawCommandRings() {
+		drawCommandRings.resize(maxFrames);
+		drawCommandCapacities.resize(maxFrames, 0u);
 	}
 
-	void Renderer::createDescriptorSetLayout() {
-		std::vector<vk::DescriptorSetLayoutBinding> bindings{
-			{
-				0u,
-				vk::DescriptorType::eUniformBuffer,
-				1u,
-				vk::ShaderStageFlagBits::eVertex
-			},
-			{
-				1u,
-				vk::DescriptorType::eCombinedImageSampler,
-				1u,
-				vk::ShaderStageFlagBits::eFragment
-			}
-		};
-		descriptorSetLayout = device->createDescriptorSetLayout({
-			{},
-			static_cast<uint32_t>(bindings.size()),
-			bindings.data()
-		});
+	// Every material's shaders declare the same interface as the default ones, so they all share this layout
+	void Renderer::createPipelineLayout() {
+		auto vertexShader = Shader::reflect(vertexShaderName(), vk::ShaderStageFlagBits::eVertex);
+		auto fragmentShader = Shader::reflect("fragment", vk::ShaderStageFlagBits::eFragment);
+		// Push constants are written straight from DrawConstants, which only the shader sources are kept in sync with
+		Logger::assertTrue(vertexShader.pushConstants && vertexShader.pushConstants->size == sizeof(DrawConstants),
+			"Vertex shader push constants do not match DrawConstants");
+		pipelineLayout = layouts->pipelineLayout({&vertexShader, &fragmentShader});
+		auto setLayouts = layouts->setLayouts(pipelineLayout);
+		Logger::assertNotEmpty(setLayouts, "Shaders declare no descriptor sets");
+		descriptorSetLayout = setLayouts.front();
+	}
+
+	std::string Renderer::vertexShaderName() const {
+		return mesh.vertexFormat() == VertexFormat::ePacked ? "packed-vertex" : "vertex";
 	}
 
-	void Renderer::updateUniformBuffer(uint32_t index) {
-		static auto startTime = std::chrono::high_resolution_clock::now();
+	// This frame's scene: settings.objectCount copies of the model spinning on a square grid around the origin
+	void Renderer::updateDrawList() {
 		auto currentTime = std::chrono::high_resolution_clock::now();
-		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-		ubo.model = glm::rotate(
+		if (!animationStart) {
+			animationStart = currentTime;
+		}
+		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - *animationStart).count();
+		auto rotation = glm::rotate(
 			glm::mat4(1.0f),
 			time * glm::radians(90.0f),
 			glm::vec3(0.0f, 0.0f, 1.0f));
+
+		auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(settings.objectCount))));
+		auto rows = columns == 0u ? 0u : (settings.objectCount + columns - 1u) / columns;
+		float spacing = 2.5f * mesh.boundsRadius();
+		// The configured variant when there is one, see createGraphicsPipeline
+		auto material = static_cast<uint32_t>(materials.size() - 1u);
+		drawList.clear();
+		for (uint32_t object = 0; object < settings.objectCount; ++object) {
+			glm::vec3 position{
+				(static_cast<float>(object % columns) - 0.5f * static_cast<float>(columns - 1u)) * spacing,
+				(static_cast<float>(object / columns) - 0.5f * static_cast<float>(rows - 1u)) * spacing,
+				0.0f
+			};
+			drawList.push_back({{glm::translate(glm::mat4(1.0f), position) * rotation, object}, material, 0u, 0u, 0u});
+		}
+	}
+
+	void Renderer::updateUniformBuffer() {
 		ubo.view = glm::lookAt(
 			glm::vec3(2.0f, 2.0f, 2.0f),
 			glm::vec3(0.0f, 0.0f, 0.0f),
 			glm::vec3(0.0f, 0.0f, 1.0f));
 		ubo.projection = glm::perspective(
-			glm::radians(45.0f),
+			fieldOfView,
 			static_cast<float>(extent.width) / static_cast<float>(extent.height),
-			0.1f, 10.0f);
+			nearPlane, farPlane);
 		ubo.projection[1][1] *= -1;
+		ubo.positionScale = glm::vec4(mesh.dequantization().scale, 0.0f);
+		ubo.positionOffset = glm::vec4(mesh.dequantization().offset, 0.0f);
 
-		copyMemory(uniformBuffers[index], &ubo, sizeof(ubo));
+		uniformRing.beginFrame(static_cast<uint32_t>(currentFrame));
+		uniformOffset = static_cast<uint32_t>(uniformRing.push(ubo));
 	}
 
-	void Renderer::createDescriptorPool() {
-		descriptorPool = device->createDescriptorPool(
-			static_cast<uint32_t>(images.size()));
+	// Coarsest level of detail whose deviation from full detail projects to at most lodErrorThreshold pixels
+	uint32_t Renderer::selectLod(glm::vec3 const& cameraPosition) {
+		float pixelsPerUnit = static_cast<float>(extent.height) / (2.0f * std::tan(fieldOfView * 0.5f));
+		float distance = std::max(glm::length(cameraPosition - mesh.boundsCenter()) - mesh.boundsRadius(), nearPlane);
+		auto const& lods = mesh.lods();
+		uint32_t selected = 0;
+		for (uint32_t lod = 1; lod < lods.size(); ++lod) {
+			if (lods[lod].error * pixelsPerUnit / distance <= settings.lodErrorThreshold) {
+				selected = lod;
+			}
+		}
+		return selected;
 	}
 
-	void Renderer::createDescriptorSets() {
-		descriptorSets = device
-			->allocateDescriptorSets(descriptorPool, descriptorSetLayout, static_cast<uint32_t>(images.size()));
-
-		for (size_t i = 0; i < descriptorSets.size(); ++i) {
-			vk::DescriptorBufferInfo bufferInfo{
-				uniformBuffers[i],
-				0u,
-				sizeof(UniformBufferObject)
-			};
-			vk::DescriptorImageInfo imageInfo{
-				textureSampler,
-				textureImage,
-				vk::ImageLayout::eShaderReadOnlyOptimal
-			};
-			std::vector<vk::WriteDescriptorSet> writeDescriptorSets{
-				{
-					descriptorSets[i],
-					0u,
-					0u,
-					1u,
-					vk::DescriptorType::eUniformBuffer,
-					nullptr,
-					&bufferInfo,
-					nullptr
-				},
-				{
-					descriptorSets[i],
-					1u,
-					0u,
-					1u,
-					vk::DescriptorType::eCombinedImageSampler,
-					&imageInfo,
-					nullptr,
-					nullptr
-				}
-			};
+	// Culls in model space, so meshlet bounds never need transforming
+	void Renderer::updateDrawCommands() {
+		auto cameraPositionFor = [this](glm::mat4 const& model) {
+			return glm::vec3(glm::inverse(ubo.view * model) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		};
 
-			device->updateDescriptorSets(writeDescriptorSets);
+		// Level of detail first, its command count bounds what an object can draw
+		uint32_t requiredCapacity = 0u;
+		for (size_t draw = 0; draw < drawList.size(); ++draw) {
+			auto& entry = drawList[draw];
+			entry.lod = selectLod(cameraPositionFor(entry.constants.model));
+			// Only the first object's level of detail is logged
+			if (draw == 0u && entry.lod != currentLod) {
+				Logger::log("Switched to LOD ", entry.lod);
+				currentLod = entry.lod;
+			}
+			requiredCapacity += lodCommandCount(mesh.lods()[entry.lod]);
 		}
-	}
 
-	void Renderer::copyMemory(vma::Allocation const& allocation, void* data, size_t size) {
-		auto mappedMemory = allocator.mapMemory(allocation);
-		memcpy(mappedMemory, data, size);
-		allocator.unmapMemory(allocation);
-	}
+		auto& drawCommandRing = drawCommandRings[currentFrame];
+		if (requiredCapacity > drawCommandCapacities[currentFrame]) {
+			// Only this frame used the old ring and its timeline point has completed
+			drawCommandRing.destroy();
+			auto capacity = std::max(requiredCapacity, 2u * drawCommandCapacities[currentFrame]);
+			drawCommandRing = RingBuffer(allocator, vk::BufferUsageFlagBits::eIndirectBuffer,
+				sizeof(vk::DrawIndexedIndirectCommand) * capacity, 1u, sizeof(vk::DrawIndexedIndirectCommand));
+			drawCommandCapacities[currentFrame] = capacity;
+		}
+		if (requiredCapacity == 0u) {
+			for (auto& entry : drawList) {
+				entry.commandCount = 0u;
+			}
+			return;
+		}
 
-	void Renderer::runCommand(std::function<void(vk::CommandBuffer)> const& callback) {
-		auto commandBuffer = device->allocateCommandBuffers({
-			commandPool,
-			vk::CommandBufferLevel::ePrimary,
-			1u
-		})[0];
-		commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-		callback(commandBuffer);
-		commandBuffer.end();
+		// Only visible draws are written, packed back to back; the unused tail of the allocation is never read
+		drawCommandRing.beginFrame(0u);
+		auto allocation = drawCommandRing.allocate(sizeof(vk::DrawIndexedIndirectCommand) * requiredCapacity);
+		auto commands = static_cast<vk::DrawIndexedIndirectCommand*>(allocation.data);
+		auto firstCommand = static_cast<uint32_t>(allocation.offset / sizeof(vk::DrawIndexedIndirectCommand));
+		uint32_t written = 0u;
+		for (auto& entry : drawList) {
+			auto const& lod = mesh.lods()[entry.lod];
+			auto drawCommands = commands + written;
+			if (meshletCulling) {
+				auto const& model = entry.constants.model;
+				entry.commandCount = cullMeshlets(mesh.meshlets().data() + lod.firstMeshlet, lod.meshletCount,
+					ubo.projection * ubo.view * model, cameraPositionFor(model), drawCommands);
+			} else {
+				for (uint32_t i = 0; i < lod.submeshCount; ++i) {
+					auto const& submesh = mesh.submeshes()[lod.firstSubmesh + i];
+					drawCommands[i] = vk::DrawIndexedIndirectCommand{submesh.indexCount, 1u, submesh.firstIndex,
+						submesh.vertexOffset, 0u};
+				}
+				entry.commandCount = lod.submeshCount;
+			}
+			entry.firstCommand = firstCommand + written;
+			written += entry.commandCount;
+		}
+	}
 
-		vk::SubmitInfo submitInfo{
-			0u, nullptr, nullptr, 1u, &commandBuffer
-		};
-		device->graphicsQueue.submit(1u, &submitInfo, vk::Fence{});
+	void Renderer::createDescriptorSets() {
+		descriptors.emplace(*device, *layouts, static_cast<uint32_t>(maxFrames));
+		descriptorSet = descriptors->cached(descriptorSetLayout, {
+			DescriptorWrite::buffer(0u, vk::DescriptorType::eUniformBufferDynamic, uniformRing, 0u,
+				sizeof(UniformBufferObject)),
+			DescriptorWrite::image(1u, vk::DescriptorType::eCombinedImageSampler, textureSampler, textureImage,
+				vk::ImageLayout::eShaderReadOnlyOptimal)
+		});
 	}
 
+
 	void Renderer::transitionImageLayout(Image& image, vk::Format const& format, uint32_t mipLevels,
 										 vk::ImageLayout const& from, vk::ImageLayout const& to) {
-		runCommand([&](vk::CommandBuffer const& commandBuffer) {
-			vk::ImageMemoryBarrier barrier{
-				accessMaskForLayout(from), accessMaskForLayout(to),
-				from, to,
-				0u, 0u,
-				image,
-				{
-					aspectMaskForLayoutAndFormat(to, format),
-					0u, mipLevels,
-					0u, 1u
-				}
-			};
-			commandBuffer.pipelineBarrier(pipelineStageForLayout(from), pipelineStageForLayout(to), {},
-				0u, nullptr,
-				0u, nullptr,
-				1u, &barrier);
+		uploads->record([&](vk::CommandBuffer const& commandBuffer) {
+			recordLayoutTransition(commandBuffer, image, format, mipLevels, from, to);
 		});
 	}
 
-	void Renderer::copyBufferToImage(Buffer& buffer, Image& image, uint32_t width, uint32_t height) {
-		runCommand([&](vk::CommandBuffer const& commandBuffer) {
-			vk::BufferImageCopy copy{
-				0u, 0u, 0u,
-				{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u},
-				{0u, 0u, 0u},
-				{width, height, 1u}
-			};
-			commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1u, &copy);
-		});
+	void Renderer::recordLayoutTransition(vk::CommandBuffer const& commandBuffer, Image& image,
+										  vk::Format const& format, uint32_t mipLevels, vk::ImageLayout const& from,
+										  vk::ImageLayout const& to) {
+		vk::ImageMemoryBarrier barrier{
+			accessMaskForLayout(from), accessMaskForLayout(to),
+			from, to,
+			VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+			image,
+			{
+				aspectMaskForLayoutAndFormat(to, format),
+				0u, mipLevels,
+				0u, 1u
+			}
+		};
+		commandBuffer.pipelineBarrier(pipelineStageForLayout(from), pipelineStageForLayout(to), {},
+			0u, nullptr,
+			0u, nullptr,
+			1u, &barrier);
 	}
 
 	vk::AccessFlags Renderer::accessMaskForLayout(vk::ImageLayout const& layout) {
@@ -837,110 +1078,27 @@ namespace Graphics {
 		}
 	}
 
-	// TODO: Pull out into separate model/mesh class
 	void Renderer::loadModel() {
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
 		static std::string const path = "../assets/models/chalet.obj";
-		Logger::assertTrue(tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()),
-			"Failed to load object: " + warn + err);
-		for (const auto& shape : shapes) {
-			for (const auto& index : shape.mesh.indices) {
-				Vertex vertex{
-					glm::vec3{
-						attrib.vertices[3 * index.vertex_index + 0],
-						attrib.vertices[3 * index.vertex_index + 1],
-						attrib.vertices[3 * index.vertex_index + 2]
-					},
-					glm::vec3{1.0f, 1.0f, 1.0f},
-					glm::vec2{
-						attrib.texcoords[2 * index.texcoord_index + 0],
-						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-					}
-				};
-				auto result = verticesHashMap.emplace(vertex, static_cast<uint32_t>(verticesHashMap.size()));
-				if (result.second) {
-					vertices.push_back(vertex);
-				}
-				indices.push_back((*(result.first)).second);
-			}
-			// Util::fillWithKeys(verticesHashMap, vertices);
+		MeshCache meshCache("cache");
+		auto cached = meshCache.load(path, settings.mesh);
+		if (cached) {
+			mesh = std::move(*cached);
+			return;
 		}
-	}
-
-	// TODO: provide pre-built mipmaps, remove software generation of mipmaps to improve load times
-	void Renderer::generateMipmaps(Image image, int width, int height) {
-		runCommand([&](vk::CommandBuffer const& commandBuffer) {
-			vk::ImageMemoryBarrier barrier{
-				{}, {}, vk::ImageLayout::eUndefined, vk::ImageLayout::eUndefined,
-				0u, 0u, image,
-				{vk::ImageAspectFlagBits::eColor, 0u, 1u, 0u, 1u}
-			};
-
-			int mipWidth = width;
-			int mipHeight = height;
-			for (uint32_t i = 1; i < mipLevels; ++i) {
-				barrier.subresourceRange.baseMipLevel = i - 1;
-				barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-				barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-				barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-				barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-				commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-					vk::PipelineStageFlagBits::eTransfer, {},
-					0u, nullptr,
-					0u, nullptr,
-					1u, &barrier);
-
-				vk::ImageBlit blit{
-					{ vk::ImageAspectFlagBits::eColor, i - 1, 0u, 1u },
-					std::array<vk::Offset3D, 2>{
-						vk::Offset3D{0, 0, 0},
-						vk::Offset3D{mipWidth, mipHeight, 1}
-					},
-					{ vk::ImageAspectFlagBits::eColor, i, 0u, 1u },
-					std::array<vk::Offset3D, 2>{
-						vk::Offset3D{0, 0, 0},
-						vk::Offset3D{mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}
-					}
-				};
-				commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal,
-					image, vk::ImageLayout::eTransferDstOptimal,
-					1u, &blit, vk::Filter::eLinear);
-
-				barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-				barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-				barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-				barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-				commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-					vk::PipelineStageFlagBits::eFragmentShader, {},
-					0u, nullptr,
-					0u, nullptr,
-					1u, &barrier);
-
-				if (mipWidth > 1) {
-					mipWidth /= 2;
-				}
-				if (mipHeight > 1) {
-					mipHeight /= 2;
-				}
-			}
 
-			// After loop, transition final mip level to shader read only optimal
-			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-			barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-			barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-			barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-				vk::PipelineStageFlagBits::eFragmentShader, {},
-				0u, nullptr,
-				0u, nullptr,
-				1u, &barrier);
-		});
+		auto parsed = ObjLoader(threadPool).load(path);
+		mesh = parsed ? std::move(*parsed) : Mesh::loadObj(path);
+		mesh.optimize();
+		if (settings.mesh.lodCount > 1u) {
+			mesh.buildLods(settings.mesh.lodCount);
+		}
+		mesh.narrowIndices();
+		if (settings.mesh.meshlets) {
+			mesh.buildMeshlets();
+		}
+		mesh.pack(settings.mesh.vertexFormat);
+		meshCache.store(path, mesh, settings.mesh);
 	}
 
 	void Renderer::createColorImage() {
@@ -5,7 +5,9 @@
 #ifndef VULKAN_ENGINE_RENDERER_HPP
 #define VULKAN_ENGINE_RENDERER_HPP
 
+#include <chrono>
 #include <cstdint>
+#include <optional>
 #include <vector>
 #include <string>
 #include <vulkan/vulkan.hpp>
@@ -14,30 +16,51 @@
 #include "../glfw/window.hpp"
 #include "../core/game.hpp"
 #include "../util/runnable.hpp"
+#include "../util/thread-pool.hpp"
 #include "device.hpp"
 #include "image.hpp"
 #include "vertex.hpp"
+#include "mesh.hpp"
+#include "texture.hpp"
 #include "buffer.hpp"
 #include "uniform-buffer-object.hpp"
+#include "draw-constants.hpp"
+#include "renderer-settings.hpp"
+#include "upload-context.hpp"
+#include "frame-timeline.hpp"
+#include "pipeline-cache.hpp"
+#include "layout-cache.hpp"
+#include "descriptor-allocator.hpp"
+#include "pipeline-manager.hpp"
+#include "shader-reloader.hpp"
+#include "command-recorder.hpp"
+#include "ring-buffer.hpp"
 
 namespace Graphics {
 	class Renderer: public Util::Runnable {
 	public:
-		explicit Renderer(Core::Game& game);
+		explicit Renderer(Core::Game& game, RendererSettings settings = {});
+		~Renderer() override;
+
+		// Average CPU time spent recording a frame's command buffers since the renderer started
+		float averageRecordingMilliseconds() const;
 
 	private:
 		static int const maxFrames = 2;
 		int currentFrame = 0;
 		Core::Game& game;
-
-		std::vector<const char*> instanceExtensions{
-			VK_KHR_SURFACE_EXTENSION_NAME
-		};
-		const std::vector<const char*> deviceExtensions{
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME
-		};
+		RendererSettings settings;
+		Util::ThreadPool threadPool;
+		uint64_t framesRendered = 0;
+		// Both set on first use, so every renderer in the process measures from its own start
+		std::optional<std::chrono::high_resolution_clock::time_point> offscreenStart;
+		std::optional<std::chrono::high_resolution_clock::time_point> animationStart;
+
+		std::vector<const char*> instanceExtensions{};
+		std::vector<const char*> deviceExtensions{};
 		std::vector<const char*> validationLayers{};
-		glfw::Window window;
+		std::optional<glfw::Window> window;
+		uint32_t apiVersion = VK_API_VERSION_1_0;
 		vk::Instance instance;
 		vk::SurfaceKHR surface;
 
@@ -47,15 +70,36 @@ namespace Graphics {
 
 		std::vector<vk::Semaphore> imageAvailableSemaphores;
 		std::vector<vk::Semaphore> renderFinishedSemaphores;
-		std::vector<vk::Fence> commandBufferFences;
-
-		vk::CommandPool commandPool;
+		std::optional<FrameTimeline> timeline;
+		// Saved back to disk when the renderer shuts down
+		std::optional<PipelineCache> pipelineCache;
+		// Timeline point of the last submission of each frame in flight
+		std::vector<uint64_t> framePoints;
+
+		// One pool per frame in flight, reset as a whole before its frame is recorded again
+		std::vector<vk::CommandPool> commandPools;
+		std::optional<UploadContext> uploads;
+		// Allocated from the pool of the same frame
 		std::vector<vk::CommandBuffer> commandBuffers;
+		// Records the draw list in parallel when more than one recording thread is configured
+		std::optional<CommandRecorder> recorder;
+		float recordingMilliseconds = 0.0f;
+		uint32_t recordedFrames = 0;
+		double totalRecordingMilliseconds = 0.0;
+		uint64_t totalRecordedFrames = 0;
 
 		vk::SurfaceFormatKHR surfaceFormat{};
 		vk::PresentModeKHR presentMode;
 		vk::Extent2D extent;
 		vk::SwapchainKHR swapchain;
+		struct RetiredSwapchain {
+			vk::SwapchainKHR swapchain;
+			// Frames still to submit before it is released through the timeline
+			uint32_t framesLeft;
+		};
+		std::vector<RetiredSwapchain> retiredSwapchains;
+		// Set while the window is minimized, the swapchain is recreated once it has an area again
+		bool swapchainOutdated = false;
 		std::vector<Image> images;
 		Image colorImage;
 		Image depthImage;
@@ -64,21 +108,50 @@ namespace Graphics {
 		std::vector<vk::Framebuffer> framebuffers;
 		vk::PipelineLayout pipelineLayout;
 		vk::DescriptorSetLayout descriptorSetLayout;
+		// Descriptor set and pipeline layouts generated from the shaders
+		std::optional<LayoutCache> layouts;
+		std::optional<PipelineManager> pipelines;
+		// Built before the first frame, drawn with while a material's own pipeline compiles
 		vk::Pipeline graphicsPipeline;
+		// Pipeline state per material, the first is the default every draw list entry starts out with
+		std::vector<PipelineState> materials;
+		// Pipeline each material draws with this frame
+		std::vector<vk::Pipeline> materialPipelines;
+		std::optional<ShaderReloader> shaderReloader;
 		Image textureImage;
 		vk::Sampler textureSampler;
 
 		Buffer vertexBuffer;
 		Buffer indexBuffer;
-		std::vector<Buffer> uniformBuffers;
-
-		vk::DescriptorPool descriptorPool;
-		std::vector<vk::DescriptorSet> descriptorSets;
-
-		std::unordered_map<Vertex, uint32_t> verticesHashMap;
-		std::vector<Vertex> vertices;
-		std::vector<uint32_t> indices;
+		// Per-frame uniform data, one partition per frame in flight
+		RingBuffer uniformRing;
+		// Dynamic offset of this frame's UniformBufferObject in uniformRing
+		uint32_t uniformOffset = 0;
+		// Per frame in flight, each frame streams the packed visible draws of its draw list through its own ring
+		std::vector<RingBuffer> drawCommandRings;
+		// Draw commands each of drawCommandRings has room for, grown when a frame needs more
+		std::vector<uint32_t> drawCommandCapacities;
+		bool meshletCulling = false;
+		uint32_t currentLod = 0;
+
+		// Transient sets of a frame are reset together with its command pool
+		std::optional<DescriptorAllocator> descriptors;
+		// Shared by every frame, the dynamic offset of binding 0 selects the frame's uniform data
+		vk::DescriptorSet descriptorSet;
+
+		Mesh mesh;
 		UniformBufferObject ubo;
+		struct Draw {
+			DrawConstants constants;
+			uint32_t material;
+			// Written by updateDrawCommands: the selected level of detail and the range of visible draws in the
+			// frame's indirect ring
+			uint32_t lod;
+			uint32_t firstCommand;
+			uint32_t commandCount;
+		};
+		// Objects drawn this frame, each with the whole mesh
+		std::vector<Draw> drawList;
 		vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1;
 
 		uint32_t mipLevels = 1u;
@@ -92,22 +165,38 @@ namespace Graphics {
 		void createInstance();
 		void choosePhysicalDevice();
 		void createSynchronization();
-		void createCommandPool();
-		void createCommandBuffers();
-		void createSwapchain();
+		void createCommandPools();
+		void recordCommandBuffer(uint32_t imageIndex);
+		void recordDraws(vk::CommandBuffer commandBuffer, size_t first, size_t end);
+		void reportRecordingCost();
+		void createSwapchain(vk::SwapchainKHR oldSwapchain);
+		void createOffscreenImages();
+		void renderOffscreen();
 		void createDepthImage();
 		void createRenderPass();
 		void createFramebuffers();
 		void createTextureImage();
+		Texture loadTexture(std::string const& path, vk::Format format);
 		void createGraphicsPipeline();
+		void resolveMaterialPipelines();
+		void reloadShaders();
+		bool keepsPipelineLayout(std::string const& shaderName);
+		void retirePipelines(std::vector<vk::Pipeline> retired);
 		void destroySwapchainAndFriends();
 		void recreateSwapchain();
-		void createSwapchainAndFriends();
+		void retireSwapchains();
+		void createSwapchainAndFriends(vk::SwapchainKHR oldSwapchain = {});
+		void chooseFormats();
 		void createVertexBuffer();
 		void createIndexBuffer();
-		void createUniformBuffers();
-		void createDescriptorSetLayout();
-		void createDescriptorPool();
+		void createUniformRing();
+		void createDrawCommandRings();
+		void updateDrawList();
+		void updateDrawCommands();
+		uint32_t lodCommandCount(MeshLod const& lod) const;
+		uint32_t selectLod(glm::vec3 const& cameraPosition);
+		void createPipelineLayout();
+		std::string vertexShaderName() const;
 		void createDescriptorSets();
 		void createTextureSampler();
 		void loadModel();
@@ -116,17 +205,14 @@ namespace Graphics {
 
 		vk::Format chooseSupportedFormat(const std::vector<vk::Format>& formats, vk::ImageTiling tiling,
 										 const vk::FormatFeatureFlags& features);
-		void copyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size);
-		void updateUniformBuffer(uint32_t index);
-		void copyMemory(vma::Allocation const& allocation, void* data, size_t size);
-		void runCommand(std::function<void(vk::CommandBuffer)> const& callback);
+		void updateUniformBuffer();
 		void transitionImageLayout(Image& image, vk::Format const& format, uint32_t mipLevels,
 								   vk::ImageLayout const& from, vk::ImageLayout const& to);
-		void copyBufferToImage(Buffer& buffer, Image& image, uint32_t width, uint32_t height);
+		static void recordLayoutTransition(vk::CommandBuffer const& commandBuffer, Image& image, vk::Format const& format,
+										   uint32_t mipLevels, vk::ImageLayout const& from, vk::ImageLayout const& to);
 		static vk::AccessFlags accessMaskForLayout(vk::ImageLayout const& layout);
 		static vk::PipelineStageFlags pipelineStageForLayout(vk::ImageLayout const& layout);
 		static vk::ImageAspectFlags aspectMaskForLayoutAndFormat(vk::ImageLayout const& layout, vk::Format const& format);
-		void generateMipmaps(Image image, int width, int height);
 		void createColorImage();
 	};
 }
@@ -0,0 +1,57 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+
+#include "ring-buffer.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	namespace {
+		vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+			return (value + alignment - 1u) / alignment * alignment;
+		}
+	}
+
+	RingBuffer::RingBuffer(vma::Allocator allocator, vk::BufferUsageFlags usage, vk::DeviceSize partitionSize,
+						   uint32_t partitionCount, vk::DeviceSize alignment)
+		: allocator(allocator), partitionSize(alignUp(partitionSize, std::max<vk::DeviceSize>(alignment, 1u))),
+		  partitionCount(partitionCount), alignment(std::max<vk::DeviceSize>(alignment, 1u)) {
+		buffer = Buffer(allocator, this->partitionSize * partitionCount, usage,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			vma::MemoryUsage::eCpuToGpu);
+		// Mapped once: coherent memory needs no flushes, so writes are plain stores from here on
+		mapped = static_cast<uint8_t*>(allocator.mapMemory(buffer));
+	}
+
+	void RingBuffer::destroy() {
+		if (!mapped) {
+			return;
+		}
+		allocator.unmapMemory(buffer);
+		allocator.destroyBuffer(buffer, buffer);
+		mapped = nullptr;
+	}
+
+	void RingBuffer::beginFrame(uint32_t partition) {
+		Logger::assertTrue(partition < partitionCount, "Ring buffer partition out of range");
+		head = partitionOffset(partition);
+		end = head + partitionSize;
+	}
+
+	RingAllocation RingBuffer::allocate(vk::DeviceSize size) {
+		auto offset = alignUp(head, alignment);
+		Logger::assertTrue(offset + size <= end, "Ring buffer partition is full");
+		head = offset + size;
+		return {offset, mapped + offset};
+	}
+
+	vk::DeviceSize RingBuffer::partitionOffset(uint32_t partition) const {
+		return partitionSize * partition;
+	}
+
+	RingBuffer::operator vk::Buffer() {
+		return buffer;
+	}
+}
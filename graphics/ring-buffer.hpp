@@ -0,0 +1,61 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_RING_BUFFER_HPP
+#define VULKAN_ENGINE_RING_BUFFER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vulkan/vulkan.hpp>
+#include <vma.hpp>
+
+#include "buffer.hpp"
+
+namespace Graphics {
+	struct RingAllocation {
+		// Offset from the start of the buffer, suitable as a dynamic offset
+		vk::DeviceSize offset;
+		void* data;
+	};
+
+	/*
+	 * A host-coherent buffer that stays mapped for its whole lifetime, split into one partition per frame.
+	 * Each frame streams its data into its own partition with aligned sub-allocations, so writing a frame never
+	 * touches memory an earlier frame still in flight is reading.
+	 */
+	class RingBuffer {
+	public:
+		RingBuffer() = default;
+		RingBuffer(vma::Allocator allocator, vk::BufferUsageFlags usage, vk::DeviceSize partitionSize,
+				   uint32_t partitionCount, vk::DeviceSize alignment);
+
+		void destroy();
+
+		// Starts a new frame in the given partition; the GPU must be done with what was written there before
+		void beginFrame(uint32_t partition);
+		// Reserves size bytes in the current partition, starting at a multiple of the alignment
+		RingAllocation allocate(vk::DeviceSize size);
+		// Copies value into the current partition and returns its offset
+		template <typename T>
+		vk::DeviceSize push(T const& value) {
+			auto allocation = allocate(sizeof(T));
+			memcpy(allocation.data, &value, sizeof(T));
+			return allocation.offset;
+		}
+
+		vk::DeviceSize partitionOffset(uint32_t partition) const;
+		operator vk::Buffer(); // NOLINT
+	private:
+		vma::Allocator allocator;
+		Buffer buffer;
+		uint8_t* mapped = nullptr;
+		vk::DeviceSize partitionSize = 0;
+		uint32_t partitionCount = 0;
+		vk::DeviceSize alignment = 1;
+		vk::DeviceSize head = 0;
+		vk::DeviceSize end = 0;
+	};
+}
+
+#endif //VULKAN_ENGINE_RING_BUFFER_HPP
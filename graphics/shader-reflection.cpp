@@ -0,0 +1,332 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "shader-reflection.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t const spirvMagic = 0x07230203u;
+		// Words before the first instruction: magic, version, generator, ID bound and schema
+		size_t const headerWords = 5u;
+
+		// The parts of the SPIR-V specification reflection reads
+		enum Opcode : uint32_t {
+			opTypeBool = 20u,
+			opTypeInt = 21u,
+			opTypeFloat = 22u,
+			opTypeVector = 23u,
+			opTypeMatrix = 24u,
+			opTypeImage = 25u,
+			opTypeSampler = 26u,
+			opTypeSampledImage = 27u,
+			opTypeArray = 28u,
+			opTypeRuntimeArray = 29u,
+			opTypeStruct = 30u,
+			opTypePointer = 32u,
+			opConstant = 43u,
+			opSpecConstant = 50u,
+			opVariable = 59u,
+			opDecorate = 71u,
+			opMemberDecorate = 72u
+		};
+
+		enum Decoration : uint32_t {
+			decorationBufferBlock = 3u,
+			decorationArrayStride = 6u,
+			decorationMatrixStride = 7u,
+			decorationBuiltIn = 11u,
+			decorationLocation = 30u,
+			decorationBinding = 33u,
+			decorationDescriptorSet = 34u,
+			decorationOffset = 35u
+		};
+
+		enum StorageClass : uint32_t {
+			storageUniformConstant = 0u,
+			storageInput = 1u,
+			storageUniform = 2u,
+			storagePushConstant = 9u,
+			storageStorageBuffer = 12u
+		};
+
+		uint32_t const dimBuffer = 5u;
+		uint32_t const dimSubpassData = 6u;
+		// Sampled operand of OpTypeImage for images used without a sampler
+		uint32_t const imageStorage = 2u;
+
+		struct Definition {
+			uint32_t opcode = 0u;
+			// Words after the result ID; constants and variables keep their result type in front
+			std::vector<uint32_t> operands;
+		};
+
+		struct Module {
+			// Types, constants and variables by result ID
+			std::vector<Definition> definitions;
+			std::vector<std::unordered_map<uint32_t, uint32_t>> decorations;
+			std::map<std::pair<uint32_t, uint32_t>, std::unordered_map<uint32_t, uint32_t>> memberDecorations;
+			std::vector<uint32_t> variables;
+
+			Definition const& definition(uint32_t id) const {
+				Logger::assertTrue(id < definitions.size() && definitions[id].opcode != 0u,
+					"SPIR-V references an undefined ID");
+				return definitions[id];
+			}
+
+			std::optional<uint32_t> decoration(uint32_t id, uint32_t decoration) const {
+				auto found = decorations[id].find(decoration);
+				return found == decorations[id].end() ? std::nullopt : std::optional<uint32_t>(found->second);
+			}
+
+			std::optional<uint32_t> memberDecoration(uint32_t structType, uint32_t member, uint32_t decoration) const {
+				auto memberEntry = memberDecorations.find({structType, member});
+				if (memberEntry == memberDecorations.end()) {
+					return std::nullopt;
+				}
+				auto found = memberEntry->second.find(decoration);
+				return found == memberEntry->second.end() ? std::nullopt : std::optional<uint32_t>(found->second);
+			}
+
+			uint32_t constantValue(uint32_t id) const {
+				auto const& constant = definition(id);
+				Logger::assertTrue(constant.opcode == opConstant || constant.opcode == opSpecConstant,
+					"SPIR-V array length is not a constant");
+				return constant.operands[1];
+			}
+		};
+
+		Module parse(std::vector<char> const& code) {
+			Logger::assertTrue(code.size() % sizeof(uint32_t) == 0u && code.size() >= headerWords * sizeof(uint32_t),
+				"SPIR-V code is truncated");
+			std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+			memcpy(words.data(), code.data(), code.size());
+			Logger::assertTrue(words[0] == spirvMagic, "Shader code is not SPIR-V");
+
+			Module module;
+			auto bound = words[3];
+			module.definitions.resize(bound);
+			module.decorations.resize(bound);
+			for (size_t word = headerWords; word < words.size();) {
+				uint32_t opcode = words[word] & 0xffffu;
+				uint32_t wordCount = words[word] >> 16u;
+				Logger::assertTrue(wordCount > 0u && word + wordCount <= words.size(), "Malformed SPIR-V instruction");
+				auto operands = words.data() + word + 1u;
+				auto operandCount = wordCount - 1u;
+				word += wordCount;
+
+				switch (opcode) {
+					case opDecorate:
+						module.decorations[operands[0]][operands[1]] = operandCount > 2u ? operands[2] : 0u;
+						break;
+					case opMemberDecorate:
+						module.memberDecorations[{operands[0], operands[1]}][operands[2]] =
+							operandCount > 3u ? operands[3] : 0u;
+						break;
+					case opConstant:
+					case opSpecConstant:
+					case opVariable: {
+						auto& definition = module.definitions[operands[1]];
+						definition.opcode = opcode;
+						definition.operands.push_back(operands[0]);
+						definition.operands.insert(definition.operands.end(), operands + 2u, operands + operandCount);
+						if (opcode == opVariable) {
+							module.variables.push_back(operands[1]);
+						}
+						break;
+					}
+					default:
+						if (opcode >= opTypeBool && opcode <= opTypePointer) {
+							module.definitions[operands[0]] = {opcode, {operands + 1u, operands + operandCount}};
+						}
+						break;
+				}
+			}
+			return module;
+		}
+
+		// Bytes a value of the type occupies in a block, following the layout decorations
+		uint32_t sizeOf(Module const& module, uint32_t type, uint32_t matrixStride) {
+			auto const& definition = module.definition(type);
+			switch (definition.opcode) {
+				case opTypeBool:
+					return 4u;
+				case opTypeInt:
+				case opTypeFloat:
+					return definition.operands[0] / 8u;
+				case opTypeVector:
+					return definition.operands[1] * sizeOf(module, definition.operands[0], 0u);
+				case opTypeMatrix:
+					return definition.operands[1] *
+						(matrixStride > 0u ? matrixStride : sizeOf(module, definition.operands[0], 0u));
+				case opTypeArray: {
+					auto stride = module.decoration(type, decorationArrayStride).value_or(0u);
+					return module.constantValue(definition.operands[1]) *
+						(stride > 0u ? stride : sizeOf(module, definition.operands[0], matrixStride));
+				}
+				case opTypeStruct: {
+					uint32_t size = 0u;
+					for (uint32_t member = 0; member < definition.operands.size(); ++member) {
+						auto offset = module.memberDecoration(type, member, decorationOffset).value_or(0u);
+						auto memberStride = module.memberDecoration(type, member, decorationMatrixStride).value_or(0u);
+						size = std::max(size, offset + sizeOf(module, definition.operands[member], memberStride));
+					}
+					return size;
+				}
+				default:
+					return 0u;
+			}
+		}
+
+		vk::DescriptorType descriptorType(Module const& module, uint32_t type, uint32_t storageClass) {
+			if (storageClass == storageUniform) {
+				// Storage buffers declared before SPIR-V 1.3 are uniform blocks decorated as BufferBlock
+				return module.decoration(type, decorationBufferBlock) ? vk::DescriptorType::eStorageBuffer
+																		: vk::DescriptorType::eUniformBuffer;
+			}
+			if (storageClass == storageStorageBuffer) {
+				return vk::DescriptorType::eStorageBuffer;
+			}
+
+			auto const& definition = module.definition(type);
+			switch (definition.opcode) {
+				case opTypeSampledImage:
+					return vk::DescriptorType::eCombinedImageSampler;
+				case opTypeSampler:
+					return vk::DescriptorType::eSampler;
+				case opTypeImage: {
+					auto dim = definition.operands[1];
+					bool storage = definition.operands[5] == imageStorage;
+					if (dim == dimBuffer) {
+						return storage ? vk::DescriptorType::eStorageTexelBuffer
+									   : vk::DescriptorType::eUniformTexelBuffer;
+					}
+					if (dim == dimSubpassData) {
+						return vk::DescriptorType::eInputAttachment;
+					}
+					return storage ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+				}
+				default:
+					throw Logger::error("Unsupported descriptor type in SPIR-V");
+			}
+		}
+
+		vk::Format vertexInputFormat(Module const& module, uint32_t type) {
+			auto const& definition = module.definition(type);
+			uint32_t components = 1u;
+			auto scalarType = type;
+			if (definition.opcode == opTypeVector) {
+				scalarType = definition.operands[0];
+				components = definition.operands[1];
+			}
+			auto const& scalar = module.definition(scalarType);
+			if (components < 1u || components > 4u || scalar.operands.empty() || scalar.operands[0] != 32u) {
+				return vk::Format::eUndefined;
+			}
+
+			static std::array<vk::Format, 4> const floatFormats{
+				vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat,
+				vk::Format::eR32G32B32A32Sfloat
+			};
+			static std::array<vk::Format, 4> const sintFormats{
+				vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint
+			};
+			static std::array<vk::Format, 4> const uintFormats{
+				vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint
+			};
+			if (scalar.opcode == opTypeFloat) {
+				return floatFormats[components - 1u];
+			}
+			if (scalar.opcode == opTypeInt) {
+				return scalar.operands[1] != 0u ? sintFormats[components - 1u] : uintFormats[components - 1u];
+			}
+			return vk::Format::eUndefined;
+		}
+	}
+
+	bool DescriptorBinding::operator==(DescriptorBinding const& other) const {
+		return set == other.set && binding == other.binding && type == other.type && count == other.count &&
+			stages == other.stages;
+	}
+
+	ShaderReflection reflectShader(std::vector<char> const& code, vk::ShaderStageFlagBits stage) {
+		auto module = parse(code);
+		ShaderReflection reflection{};
+		reflection.stage = stage;
+
+		for (auto variable : module.variables) {
+			auto const& definition = module.definition(variable);
+			auto storageClass = definition.operands[1];
+			// Variables are pointers, operands of OpTypePointer are the storage class and the pointee
+			auto type = module.definition(definition.operands[0]).operands[1];
+
+			switch (storageClass) {
+				case storageUniformConstant:
+				case storageUniform:
+				case storageStorageBuffer: {
+					auto binding = module.decoration(variable, decorationBinding);
+					if (!binding) {
+						break;
+					}
+					uint32_t count = 1u;
+					auto const& bindingType = module.definition(type);
+					Logger::assertTrue(bindingType.opcode != opTypeRuntimeArray,
+						"Runtime sized descriptor arrays are not supported");
+					if (bindingType.opcode == opTypeArray) {
+						count = module.constantValue(bindingType.operands[1]);
+						type = bindingType.operands[0];
+					}
+					reflection.bindings.push_back({
+						module.decoration(variable, decorationDescriptorSet).value_or(0u),
+						*binding,
+						descriptorType(module, type, storageClass),
+						count,
+						stage
+					});
+					break;
+				}
+				case storagePushConstant: {
+					auto const& block = module.definition(type);
+					uint32_t offset = UINT32_MAX;
+					for (uint32_t member = 0; member < block.operands.size(); ++member) {
+						offset = std::min(offset, module.memberDecoration(type, member, decorationOffset).value_or(0u));
+					}
+					auto size = sizeOf(module, type, 0u);
+					if (size > 0u) {
+						reflection.pushConstants = vk::PushConstantRange{stage, offset, size - offset};
+					}
+					break;
+				}
+				case storageInput: {
+					auto location = module.decoration(variable, decorationLocation);
+					if (stage == vk::ShaderStageFlagBits::eVertex && location &&
+						!module.decoration(variable, decorationBuiltIn)) {
+						reflection.vertexInputs.push_back({*location, vertexInputFormat(module, type)});
+					}
+					break;
+				}
+				default:
+					break;
+			}
+		}
+
+		std::sort(reflection.bindings.begin(), reflection.bindings.end(),
+			[](DescriptorBinding const& a, DescriptorBinding const& b) {
+				return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+			});
+		std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(),
+			[](VertexInput const& a, VertexInput const& b) {
+				return a.location < b.location;
+			});
+		return reflection;
+	}
+}
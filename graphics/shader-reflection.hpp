@@ -0,0 +1,49 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_SHADER_REFLECTION_HPP
+#define VULKAN_ENGINE_SHADER_REFLECTION_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace Graphics {
+	// Plain 32-bit fields without padding, so lists of bindings hash byte for byte
+	struct DescriptorBinding {
+		uint32_t set;
+		uint32_t binding;
+		vk::DescriptorType type;
+		uint32_t count;
+		vk::ShaderStageFlags stages;
+
+		bool operator==(DescriptorBinding const& other) const;
+	};
+
+	struct VertexInput {
+		uint32_t location;
+		// Undefined for types vertex attributes can not feed
+		vk::Format format;
+	};
+
+	// Resource interface of one shader stage, read from its SPIR-V
+	struct ShaderReflection {
+		vk::ShaderStageFlagBits stage;
+		// Sorted by set, then binding
+		std::vector<DescriptorBinding> bindings;
+		std::optional<vk::PushConstantRange> pushConstants;
+		// Only filled for vertex shaders, sorted by location
+		std::vector<VertexInput> vertexInputs;
+	};
+
+	/*
+	 * Walks the declarations of a SPIR-V module: descriptor variables with their set, binding, type and array size,
+	 * the push constant block's extent from its member offsets and the vertex shader's input locations. Runtime
+	 * sized descriptor arrays are not supported.
+	 */
+	ShaderReflection reflectShader(std::vector<char> const& code, vk::ShaderStageFlagBits stage);
+}
+
+#endif //VULKAN_ENGINE_SHADER_REFLECTION_HPP
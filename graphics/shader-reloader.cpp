@@ -0,0 +1,112 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <set>
+#include <utility>
+
+#include "shader-reloader.hpp"
+#include "../logger/logger.hpp"
+#include "../util/atomic-file.hpp"
+#include "../util/mapped-file.hpp"
+
+namespace Graphics {
+	namespace {
+		// Source file and the name it is compiled to, the same pairs compile-shaders.sh builds
+		std::array<std::pair<char const*, char const*>, 3> const shaderSources{{
+			{"shader.vert", "vertex"},
+			{"shader-packed.vert", "packed-vertex"},
+			{"shader.frag", "fragment"}
+		}};
+		// How long the watcher blocks before checking whether it should stop
+		int const pollMilliseconds = 100;
+	}
+
+	ShaderReloader::ShaderReloader(std::string sourceDirectory): sourceDirectory(std::move(sourceDirectory)) {
+		inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotify < 0) {
+			throw Logger::error("failed to initialize inotify");
+		}
+		// Editors either write in place or rename a new file over the old one
+		if (inotify_add_watch(inotify, this->sourceDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+			close(inotify);
+			throw Logger::error("failed to watch shader directory " + this->sourceDirectory);
+		}
+		watcher = std::thread(&ShaderReloader::watch, this);
+		Logger::log("Watching ", this->sourceDirectory, " for shader changes");
+	}
+
+	ShaderReloader::~ShaderReloader() {
+		stopping = true;
+		watcher.join();
+		close(inotify);
+	}
+
+	std::vector<std::string> ShaderReloader::takeReloaded() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return std::exchange(reloaded, {});
+	}
+
+	void ShaderReloader::watch() {
+		alignas(inotify_event) std::array<char, 4096> buffer{};
+		while (!stopping) {
+			pollfd descriptor{inotify, POLLIN, 0};
+			if (poll(&descriptor, 1, pollMilliseconds) <= 0) {
+				continue;
+			}
+			auto length = read(inotify, buffer.data(), buffer.size());
+			if (length <= 0) {
+				continue;
+			}
+
+			// One save often produces several events, each source is compiled once per batch
+			std::set<std::string> changed;
+			for (ssize_t offset = 0; offset < length;) {
+				auto event = reinterpret_cast<inotify_event const*>(buffer.data() + offset);
+				if (event->len > 0) {
+					changed.insert(event->name);
+				}
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+			}
+
+			for (auto const& [source, shaderName] : shaderSources) {
+				if (changed.count(source) == 0 || !compile(source, shaderName)) {
+					continue;
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				if (std::find(reloaded.begin(), reloaded.end(), shaderName) == reloaded.end()) {
+					reloaded.emplace_back(shaderName);
+				}
+			}
+		}
+	}
+
+	bool ShaderReloader::compile(std::string const& source, std::string const& shaderName) {
+		auto output = "shaders/" + shaderName + ".spv";
+		// The compiler output is copied over so the renderer never maps a shader glslang is still writing
+		auto compiled = output + ".compiled";
+		auto command = "glslangValidator -V \"" + sourceDirectory + "/" + source + "\" -o \"" + compiled + "\"";
+		if (std::system(command.c_str()) != 0) {
+			Logger::log("Failed to compile ", source, ", keeping the previous ", shaderName, " shader");
+			return false;
+		}
+		try {
+			Util::MappedFile code(compiled);
+			Util::writeFileAtomically(output, {{code.data(), code.size()}});
+		} catch (std::exception const& exception) {
+			Logger::log("Failed to replace ", output, ": ", exception.what());
+			return false;
+		}
+		std::error_code error;
+		std::filesystem::remove(compiled, error);
+		Logger::log("Recompiled ", source, " to ", output);
+		return true;
+	}
+}
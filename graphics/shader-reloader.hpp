@@ -0,0 +1,42 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_SHADER_RELOADER_HPP
+#define VULKAN_ENGINE_SHADER_RELOADER_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Graphics {
+	/*
+	 * Development aid that watches the GLSL sources with inotify and recompiles each one that is saved to the
+	 * SPIR-V file the Shader class loads, on a thread of its own. The renderer collects the names of recompiled
+	 * shaders between frames and swaps in new pipelines; a source that fails to compile keeps its previous SPIR-V.
+	 */
+	class ShaderReloader {
+	public:
+		explicit ShaderReloader(std::string sourceDirectory);
+		~ShaderReloader();
+		ShaderReloader(ShaderReloader const&) = delete;
+		ShaderReloader& operator=(ShaderReloader const&) = delete;
+
+		// Names of the shaders recompiled since the last call
+		std::vector<std::string> takeReloaded();
+	private:
+		std::string sourceDirectory;
+		int inotify = -1;
+		std::atomic<bool> stopping{false};
+		std::mutex mutex;
+		std::vector<std::string> reloaded;
+		std::thread watcher;
+
+		void watch();
+		bool compile(std::string const& source, std::string const& shaderName);
+	};
+}
+
+#endif //VULKAN_ENGINE_SHADER_RELOADER_HPP
@@ -0,0 +1,38 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include "shader-variant.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	ShaderVariant& ShaderVariant::set(uint32_t constantId, uint32_t value) {
+		Logger::assertTrue(constantId < maxConstants, "Specialization constant ID out of range");
+		setMask |= 1u << constantId;
+		values[constantId] = value;
+		return *this;
+	}
+
+	bool ShaderVariant::empty() const {
+		return setMask == 0u;
+	}
+
+	Specialization::Specialization(ShaderVariant const& variant) {
+		for (uint32_t constantId = 0; constantId < ShaderVariant::maxConstants; ++constantId) {
+			if (variant.setMask & (1u << constantId)) {
+				entries.emplace_back(constantId, static_cast<uint32_t>(constantId * sizeof(uint32_t)),
+					sizeof(uint32_t));
+			}
+		}
+		specializationInfo = vk::SpecializationInfo{
+			static_cast<uint32_t>(entries.size()),
+			entries.data(),
+			sizeof(variant.values),
+			variant.values
+		};
+	}
+
+	vk::SpecializationInfo const* Specialization::info() const {
+		return entries.empty() ? nullptr : &specializationInfo;
+	}
+}
@@ -0,0 +1,55 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_SHADER_VARIANT_HPP
+#define VULKAN_ENGINE_SHADER_VARIANT_HPP
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace Graphics {
+	// Specialization constant IDs of shader.frag
+	enum class FragmentConstant : uint32_t {
+		// Blends the texture towards the vertex color instead of modulating it
+		eMixVertexColor = 0,
+		// Box filter radius in texels, 0 samples the texture once
+		eBlurRadius = 1
+	};
+
+	/*
+	 * Values for a shader's specialization constants. Constants that are not set keep the default from the shader
+	 * source, so the driver compiles each variant with its switches and loop counts folded into straight-line code.
+	 * Plain 32-bit values without pointers, which lets it take part in PipelineState hashing.
+	 */
+	struct ShaderVariant {
+		static uint32_t const maxConstants = 8u;
+
+		uint32_t setMask = 0u;
+		uint32_t values[maxConstants] = {};
+
+		template <typename Constant>
+		ShaderVariant& set(Constant constant, uint32_t value) {
+			return set(static_cast<uint32_t>(constant), value);
+		}
+		ShaderVariant& set(uint32_t constantId, uint32_t value);
+		bool empty() const;
+	};
+
+	// Specialization info for the constants set in a variant, which has to outlive it
+	class Specialization {
+	public:
+		explicit Specialization(ShaderVariant const& variant);
+		Specialization(Specialization const&) = delete;
+		Specialization& operator=(Specialization const&) = delete;
+
+		// Null for variants without constants
+		vk::SpecializationInfo const* info() const;
+	private:
+		std::vector<vk::SpecializationMapEntry> entries;
+		vk::SpecializationInfo specializationInfo;
+	};
+}
+
+#endif //VULKAN_ENGINE_SHADER_VARIANT_HPP
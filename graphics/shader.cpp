@@ -7,19 +7,34 @@
 
 namespace Graphics {
 	Shader::Shader(std::string const& shaderName, Device* device, const vk::ShaderStageFlagBits& stage):
-		code{loadShaderCode(shaderName)}, shaderModule{device->createShaderModule(code)}, stage(stage) {}
+		code{loadShaderCode(shaderName)}, stage(stage), reflection{reflectShader(code, stage)},
+		shaderModule{device->createShaderModule(code)} {}
+
+	ShaderReflection Shader::reflect(std::string const& shaderName, vk::ShaderStageFlagBits stage) {
+		return reflectShader(loadShaderCode(shaderName), stage);
+	}
 
 	std::vector<char> Shader::loadShaderCode(std::string const& shaderName) {
 		return Util::readFile("shaders/" + shaderName + ".spv");
 	}
 
-	vk::PipelineShaderStageCreateInfo Shader::getShaderStageCreateInfo() {
+	vk::PipelineShaderStageCreateInfo Shader::getShaderStageCreateInfo(vk::SpecializationInfo const* specialization) {
 		return {
 			{},
 			stage,
 			shaderModule,
-			"main"
+			"main",
+			specialization
 		};
 	}
 
+	ShaderReflection const& Shader::getReflection() const {
+		return reflection;
+	}
+
+	void Shader::destroy(Device* device) {
+		device->destroyShaderModule(shaderModule);
+		shaderModule = vk::ShaderModule{};
+	}
+
 }
\ No newline at end of file
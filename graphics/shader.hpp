@@ -9,16 +9,25 @@
 #include <string>
 #include <vector>
 #include "device.hpp"
+#include "shader-reflection.hpp"
 
 namespace Graphics {
 	class Shader {
 	public:
 		Shader(std::string const& shaderName, Device* device, const vk::ShaderStageFlagBits& stage);
-		vk::PipelineShaderStageCreateInfo getShaderStageCreateInfo();
+		vk::PipelineShaderStageCreateInfo getShaderStageCreateInfo(vk::SpecializationInfo const* specialization = nullptr);
+		ShaderReflection const& getReflection() const;
+		// Pipelines keep what they need, the module can go once they are created
+		void destroy(Device* device);
+
+		// Reads the interface of a shader without creating a module for it
+		static ShaderReflection reflect(std::string const& shaderName, vk::ShaderStageFlagBits stage);
 	private:
 		std::vector<char> code;
-		vk::ShaderModule shaderModule;
 		vk::ShaderStageFlagBits stage;
+		// Reflected before the module is created, so a shader that fails reflection leaves no module behind
+		ShaderReflection reflection;
+		vk::ShaderModule shaderModule;
 		static std::vector<char> loadShaderCode(std::string const& shaderName);
 	};
 }
@@ -0,0 +1,28 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Unorm positions relative to the mesh bounds and half float texture coordinates, see Graphics::PackedVertex
+layout(location = 0) in vec4 inPosition;
+layout(location = 2) in vec2 inTexCoord;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 projection;
+    vec4 positionScale;
+    vec4 positionOffset;
+} ubo;
+
+layout(push_constant) uniform DrawConstants {
+    mat4 model;
+    uint objectId;
+} draw;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+void main() {
+    vec3 position = inPosition.xyz * ubo.positionScale.xyz + ubo.positionOffset.xyz;
+    gl_Position = ubo.projection * ubo.view * draw.model * vec4(position, 1.0);
+    fragColor = vec3(1.0);
+    fragTexCoord = inTexCoord;
+}
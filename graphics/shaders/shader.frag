@@ -6,9 +6,31 @@ layout(location = 1) in vec2 fragTexCoord;
 
 layout(binding = 1) uniform sampler2D texSampler;
 
+// Specialization constants, IDs match FragmentConstant in graphics/shader-variant.hpp
+layout(constant_id = 0) const bool mixVertexColor = false;
+layout(constant_id = 1) const int blurRadius = 0;
+
 layout(location = 0) out vec4 outColor;
 
+vec3 sampleTexture() {
+    if (blurRadius == 0) {
+        return texture(texSampler, fragTexCoord).rgb;
+    }
+    vec2 texel = 1.0 / vec2(textureSize(texSampler, 0));
+    vec3 sum = vec3(0.0);
+    for (int y = -blurRadius; y <= blurRadius; ++y) {
+        for (int x = -blurRadius; x <= blurRadius; ++x) {
+            sum += texture(texSampler, fragTexCoord + vec2(x, y) * texel).rgb;
+        }
+    }
+    return sum / float((2 * blurRadius + 1) * (2 * blurRadius + 1));
+}
+
 void main() {
-    outColor = vec4(fragColor * texture(texSampler, fragTexCoord).rgb, 1.0);
-    // outColor = mix(texture(texSampler, fragTexCoord), fragColor, 0.2);
+    vec3 textureColor = sampleTexture();
+    if (mixVertexColor) {
+        outColor = vec4(mix(textureColor, fragColor, 0.2), 1.0);
+    } else {
+        outColor = vec4(fragColor * textureColor, 1.0);
+    }
 }
@@ -0,0 +1,249 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "texture-cooker.hpp"
+#include "block-compression.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	namespace {
+		// Filter half width in destination texels and Kaiser window shape
+		float const filterRadius = 1.5f;
+		float const kaiserAlpha = 4.0f;
+		size_t const rowsPerTask = 16u;
+		float const pi = 3.14159265f;
+
+		float besselI0(float x) {
+			float sum = 1.0f;
+			float term = 1.0f;
+			float halfX = x * 0.5f;
+			for (int k = 1; k < 16; ++k) {
+				term *= halfX / static_cast<float>(k);
+				sum += term * term;
+			}
+			return sum;
+		}
+
+		float kaiserSinc(float x) {
+			if (std::abs(x) >= filterRadius) {
+				return 0.0f;
+			}
+			float sinc = x == 0.0f ? 1.0f : std::sin(pi * x) / (pi * x);
+			float t = x / filterRadius;
+			return sinc * besselI0(kaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kaiserAlpha);
+		}
+
+		float srgbToLinear(float c) {
+			return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+
+		uint8_t linearToSrgb(float c) {
+			c = std::min(std::max(c, 0.0f), 1.0f);
+			float encoded = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+			return static_cast<uint8_t>(encoded * 255.0f + 0.5f);
+		}
+
+		uint8_t linearToUnorm(float c) {
+			return static_cast<uint8_t>(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f);
+		}
+
+		/*
+		 * Weights of one axis, taps per destination texel. Source indices are clamped at the edges, so odd
+		 * sizes and the last levels of non-square textures need no special cases.
+		 */
+		struct Filter {
+			uint32_t taps;
+			std::vector<uint32_t> indices;
+			std::vector<float> weights;
+		};
+
+		Filter buildFilter(uint32_t sourceSize, uint32_t targetSize) {
+			float scale = static_cast<float>(sourceSize) / static_cast<float>(targetSize);
+			float support = filterRadius * scale;
+			Filter filter{static_cast<uint32_t>(std::ceil(2.0f * support)) + 1u, {}, {}};
+			filter.indices.resize(static_cast<size_t>(targetSize) * filter.taps);
+			filter.weights.resize(filter.indices.size());
+			for (uint32_t target = 0; target < targetSize; ++target) {
+				float center = (static_cast<float>(target) + 0.5f) * scale;
+				auto first = static_cast<int64_t>(std::floor(center - support));
+				float sum = 0.0f;
+				for (uint32_t tap = 0; tap < filter.taps; ++tap) {
+					int64_t source = first + tap;
+					float weight = kaiserSinc((static_cast<float>(source) + 0.5f - center) / scale);
+					size_t slot = static_cast<size_t>(target) * filter.taps + tap;
+					filter.indices[slot] = static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(source, 0), sourceSize - 1));
+					filter.weights[slot] = weight;
+					sum += weight;
+				}
+				for (uint32_t tap = 0; tap < filter.taps; ++tap) {
+					filter.weights[static_cast<size_t>(target) * filter.taps + tap] /= sum;
+				}
+			}
+			return filter;
+		}
+
+		// Runs body(first, last) over [0, count) in bands of rowsPerTask
+		void forEachBand(Util::ThreadPool& threadPool, size_t count, std::function<void(size_t, size_t)> const& body) {
+			threadPool.parallelFor((count + rowsPerTask - 1u) / rowsPerTask, [&](size_t band) {
+				body(band * rowsPerTask, std::min(count, (band + 1u) * rowsPerTask));
+			});
+		}
+
+		// Filters an RGBA float image to the target size, horizontally then vertically
+		std::vector<float> resample(std::vector<float> const& source, uint32_t width, uint32_t height,
+									uint32_t targetWidth, uint32_t targetHeight, Util::ThreadPool& threadPool) {
+			auto horizontal = buildFilter(width, targetWidth);
+			auto vertical = buildFilter(height, targetHeight);
+			size_t targetRow = static_cast<size_t>(targetWidth) * 4u;
+
+			std::vector<float> rows(targetRow * height);
+			forEachBand(threadPool, height, [&](size_t first, size_t last) {
+				for (size_t y = first; y < last; ++y) {
+					float const* sourceRow = &source[y * width * 4u];
+					float* out = &rows[y * targetRow];
+					for (size_t x = 0; x < targetWidth; ++x) {
+						float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+						for (size_t tap = 0; tap < horizontal.taps; ++tap) {
+							float weight = horizontal.weights[x * horizontal.taps + tap];
+							float const* texel = sourceRow + horizontal.indices[x * horizontal.taps + tap] * 4u;
+							for (size_t channel = 0; channel < 4u; ++channel) {
+								sum[channel] += weight * texel[channel];
+							}
+						}
+						for (size_t channel = 0; channel < 4u; ++channel) {
+							out[4u * x + channel] = sum[channel];
+						}
+					}
+				}
+			});
+
+			std::vector<float> result(targetRow * targetHeight, 0.0f);
+			forEachBand(threadPool, targetHeight, [&](size_t first, size_t last) {
+				for (size_t y = first; y < last; ++y) {
+					float* out = &result[y * targetRow];
+					for (size_t tap = 0; tap < vertical.taps; ++tap) {
+						float weight = vertical.weights[y * vertical.taps + tap];
+						float const* row = &rows[vertical.indices[y * vertical.taps + tap] * targetRow];
+						for (size_t i = 0; i < targetRow; ++i) {
+							out[i] += weight * row[i];
+						}
+					}
+				}
+			});
+			return result;
+		}
+
+		using BlockEncoder = void (*)(uint8_t const*, uint8_t*);
+
+		BlockEncoder blockEncoderFor(vk::Format format) {
+			switch (format) {
+				case vk::Format::eBc1RgbUnormBlock:
+				case vk::Format::eBc1RgbSrgbBlock:
+					return encodeBc1Block;
+				case vk::Format::eBc3UnormBlock:
+				case vk::Format::eBc3SrgbBlock:
+					return encodeBc3Block;
+				case vk::Format::eBc7UnormBlock:
+				case vk::Format::eBc7SrgbBlock:
+					return encodeBc7Block;
+				default:
+					return nullptr;
+			}
+		}
+
+		// Encodes an RGBA8 level into 4x4 blocks, texels past the edge repeat the last row and column
+		std::vector<uint8_t> compressLevel(std::vector<uint8_t> const& texels, uint32_t width, uint32_t height,
+										   FormatBlock const& block, BlockEncoder encoder,
+										   Util::ThreadPool& threadPool) {
+			uint32_t blocksWide = (width + 3u) / 4u;
+			uint32_t blocksHigh = (height + 3u) / 4u;
+			std::vector<uint8_t> blocks(static_cast<size_t>(blocksWide) * blocksHigh * block.size);
+			forEachBand(threadPool, blocksHigh, [&](size_t first, size_t last) {
+				uint8_t gathered[64];
+				for (size_t blockY = first; blockY < last; ++blockY) {
+					for (size_t blockX = 0; blockX < blocksWide; ++blockX) {
+						for (size_t y = 0; y < 4u; ++y) {
+							size_t sourceY = std::min<size_t>(4u * blockY + y, height - 1u);
+							for (size_t x = 0; x < 4u; ++x) {
+								size_t sourceX = std::min<size_t>(4u * blockX + x, width - 1u);
+								memcpy(&gathered[4u * (4u * y + x)], &texels[4u * (sourceY * width + sourceX)], 4u);
+							}
+						}
+						encoder(gathered, &blocks[(blockY * blocksWide + blockX) * block.size]);
+					}
+				}
+			});
+			return blocks;
+		}
+	}
+
+	Texture cookTexture(std::string const& sourcePath, vk::Format format, Util::ThreadPool& threadPool) {
+		auto block = formatBlock(format);
+		auto encoder = blockEncoderFor(format);
+		Logger::assertTrue(block && (encoder || block->width == 1u), "Textures can not be cooked to this format");
+
+		int width, height, channels;
+		stbi_uc* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels) {
+			throw Logger::error("Failed to load image " + sourcePath);
+		}
+
+		float srgbTable[256];
+		for (int value = 0; value < 256; ++value) {
+			srgbTable[value] = srgbToLinear(static_cast<float>(value) / 255.0f);
+		}
+
+		size_t texelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+		std::vector<float> linear(texelCount * 4u);
+		for (size_t i = 0; i < texelCount * 4u; ++i) {
+			linear[i] = i % 4u == 3u ? static_cast<float>(pixels[i]) / 255.0f : srgbTable[pixels[i]];
+		}
+
+		std::vector<std::vector<uint8_t>> levelData;
+		levelData.emplace_back(pixels, pixels + texelCount * 4u);
+		stbi_image_free(pixels);
+
+		std::vector<TextureLevel> levels{{static_cast<uint32_t>(width), static_cast<uint32_t>(height), 0u, texelCount * 4u}};
+		while (levels.back().width > 1u || levels.back().height > 1u) {
+			auto previous = levels.back();
+			uint32_t levelWidth = std::max(previous.width / 2u, 1u);
+			uint32_t levelHeight = std::max(previous.height / 2u, 1u);
+			linear = resample(linear, previous.width, previous.height, levelWidth, levelHeight, threadPool);
+
+			std::vector<uint8_t> bytes(linear.size());
+			for (size_t i = 0; i < linear.size(); ++i) {
+				bytes[i] = i % 4u == 3u ? linearToUnorm(linear[i]) : linearToSrgb(linear[i]);
+			}
+			levels.push_back({levelWidth, levelHeight, 0u, bytes.size()});
+			levelData.push_back(std::move(bytes));
+		}
+
+		if (encoder) {
+			for (size_t level = 0; level < levels.size(); ++level) {
+				levelData[level] = compressLevel(levelData[level], levels[level].width, levels[level].height, *block,
+					encoder, threadPool);
+				levels[level].size = levelData[level].size();
+			}
+		}
+
+		// Smallest level first, matching the order levels are stored in KTX2
+		auto alignment = Texture::levelAlignment(format);
+		std::vector<uint8_t> data;
+		for (size_t level = levels.size(); level-- > 0u;) {
+			data.resize((data.size() + alignment - 1u) / alignment * alignment);
+			levels[level].offset = data.size();
+			data.insert(data.end(), levelData[level].begin(), levelData[level].end());
+		}
+
+		Logger::log("Cooked ", levels.size(), " mip levels of ", sourcePath, " into ", data.size(), " bytes");
+		return Texture(format, std::move(levels), std::move(data));
+	}
+}
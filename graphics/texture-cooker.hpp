@@ -0,0 +1,23 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_TEXTURE_COOKER_HPP
+#define VULKAN_ENGINE_TEXTURE_COOKER_HPP
+
+#include <string>
+
+#include "texture.hpp"
+#include "../util/thread-pool.hpp"
+
+namespace Graphics {
+	/*
+	 * Decodes an image file and builds its full mip chain offline. Each level is filtered from the previous one
+	 * with a separable Kaiser-windowed sinc in linear light: color channels are treated as sRGB encoded and
+	 * converted to linear before filtering, alpha is filtered as is. Levels are then block compressed in
+	 * parallel when format is one of the BC1, BC3 or BC7 formats, or stored as is for R8G8B8A8.
+	 */
+	Texture cookTexture(std::string const& sourcePath, vk::Format format, Util::ThreadPool& threadPool);
+}
+
+#endif //VULKAN_ENGINE_TEXTURE_COOKER_HPP
@@ -0,0 +1,290 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include "texture.hpp"
+#include "../logger/logger.hpp"
+#include "../util/atomic-file.hpp"
+
+namespace Graphics {
+	namespace {
+		uint8_t const identifier[12] = {0xABu, 'K', 'T', 'X', ' ', '2', '0', 0xBBu, '\r', '\n', 0x1Au, '\n'};
+
+		struct Ktx2Header {
+			uint8_t identifier[12];
+			uint32_t vkFormat;
+			uint32_t typeSize;
+			uint32_t pixelWidth;
+			uint32_t pixelHeight;
+			uint32_t pixelDepth;
+			uint32_t layerCount;
+			uint32_t faceCount;
+			uint32_t levelCount;
+			uint32_t supercompressionScheme;
+			uint32_t dfdByteOffset;
+			uint32_t dfdByteLength;
+			uint32_t kvdByteOffset;
+			uint32_t kvdByteLength;
+			uint64_t sgdByteOffset;
+			uint64_t sgdByteLength;
+		};
+
+		struct Ktx2Level {
+			uint64_t byteOffset;
+			uint64_t byteLength;
+			uint64_t uncompressedByteLength;
+		};
+
+		// Khronos Data Format descriptor values used by the formats below
+		uint32_t const colorModelRgbsda = 1u;
+		uint32_t const colorModelBc1a = 128u;
+		uint32_t const colorModelBc3 = 130u;
+		uint32_t const colorModelBc7 = 134u;
+		uint32_t const colorPrimariesBt709 = 1u;
+		uint32_t const transferLinear = 1u;
+		uint32_t const transferSrgb = 2u;
+		uint8_t const channelColor = 0u;
+		uint8_t const channelAlpha = 15u;
+		uint8_t const sampleLinear = 0x10u;
+
+		struct DfdSample {
+			uint32_t bitOffset;
+			uint32_t bitLength;
+			uint8_t channelType;
+			uint32_t upper;
+		};
+
+		bool isSrgb(vk::Format format) {
+			switch (format) {
+				case vk::Format::eR8G8B8A8Srgb:
+				case vk::Format::eBc1RgbSrgbBlock:
+				case vk::Format::eBc3SrgbBlock:
+				case vk::Format::eBc7SrgbBlock:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		// Basic data format descriptor block (KTX2 requires one) including the leading total size
+		std::vector<uint32_t> dataFormatDescriptor(vk::Format format, FormatBlock const& block) {
+			uint32_t transfer = isSrgb(format) ? transferSrgb : transferLinear;
+			// Alpha is never sRGB encoded
+			auto alpha = static_cast<uint8_t>(channelAlpha | (transfer == transferSrgb ? sampleLinear : 0u));
+			uint32_t colorModel;
+			std::vector<DfdSample> samples;
+			switch (format) {
+				case vk::Format::eBc1RgbUnormBlock:
+				case vk::Format::eBc1RgbSrgbBlock:
+					colorModel = colorModelBc1a;
+					samples.push_back({0u, 64u, channelColor, UINT32_MAX});
+					break;
+				case vk::Format::eBc3UnormBlock:
+				case vk::Format::eBc3SrgbBlock:
+					colorModel = colorModelBc3;
+					samples.push_back({0u, 64u, alpha, UINT32_MAX});
+					samples.push_back({64u, 64u, channelColor, UINT32_MAX});
+					break;
+				case vk::Format::eBc7UnormBlock:
+				case vk::Format::eBc7SrgbBlock:
+					colorModel = colorModelBc7;
+					samples.push_back({0u, 128u, channelColor, UINT32_MAX});
+					break;
+				default:
+					colorModel = colorModelRgbsda;
+					for (uint8_t channel = 0; channel < 3u; ++channel) {
+						samples.push_back({8u * channel, 8u, channel, 255u});
+					}
+					samples.push_back({24u, 8u, alpha, 255u});
+					break;
+			}
+
+			auto blockSize = static_cast<uint32_t>(24u + 16u * samples.size());
+			std::vector<uint32_t> words{
+				4u + blockSize,
+				0u,
+				2u | blockSize << 16u,
+				colorModel | colorPrimariesBt709 << 8u | transfer << 16u,
+				(block.width - 1u) | (block.height - 1u) << 8u,
+				block.size,
+				0u
+			};
+			for (auto const& sample : samples) {
+				words.push_back(sample.bitOffset | (sample.bitLength - 1u) << 16u |
+					static_cast<uint32_t>(sample.channelType) << 24u);
+				words.push_back(0u);
+				words.push_back(0u);
+				words.push_back(sample.upper);
+			}
+			return words;
+		}
+
+		size_t alignUp(size_t value, size_t alignment) {
+			return (value + alignment - 1u) / alignment * alignment;
+		}
+
+		size_t levelSize(FormatBlock const& block, uint32_t width, uint32_t height) {
+			return static_cast<size_t>((width + block.width - 1u) / block.width) *
+				((height + block.height - 1u) / block.height) * block.size;
+		}
+	}
+
+	std::optional<FormatBlock> formatBlock(vk::Format format) {
+		switch (format) {
+			case vk::Format::eR8G8B8A8Unorm:
+			case vk::Format::eR8G8B8A8Srgb:
+				return FormatBlock{1u, 1u, 4u};
+			case vk::Format::eBc1RgbUnormBlock:
+			case vk::Format::eBc1RgbSrgbBlock:
+				return FormatBlock{4u, 4u, 8u};
+			case vk::Format::eBc3UnormBlock:
+			case vk::Format::eBc3SrgbBlock:
+			case vk::Format::eBc7UnormBlock:
+			case vk::Format::eBc7SrgbBlock:
+				return FormatBlock{4u, 4u, 16u};
+			default:
+				return {};
+		}
+	}
+
+	size_t Texture::levelAlignment(vk::Format format) {
+		auto block = formatBlock(format);
+		return block && block->size % 4u == 0u ? block->size : 4u;
+	}
+
+	Texture::Texture(vk::Format format, std::vector<TextureLevel> levels, std::vector<uint8_t> data)
+		: textureFormat(format), textureLevels(std::move(levels)), ownedData(std::move(data)),
+		  dataPointer(ownedData.data()), size(ownedData.size()) {}
+
+	std::optional<Texture> Texture::loadKtx2(std::string const& path) {
+		std::error_code error;
+		if (!std::filesystem::exists(path, error)) {
+			return {};
+		}
+
+		Util::MappedFile file(path);
+		Ktx2Header header{};
+		if (file.size() < sizeof(Ktx2Header)) {
+			return {};
+		}
+		memcpy(&header, file.data(), sizeof(Ktx2Header));
+		auto format = static_cast<vk::Format>(header.vkFormat);
+		auto block = formatBlock(format);
+		if (memcmp(header.identifier, identifier, sizeof(identifier)) != 0 || !block || header.pixelWidth == 0u ||
+			header.pixelHeight == 0u || header.pixelDepth != 0u || header.layerCount > 1u || header.faceCount != 1u ||
+			header.levelCount == 0u || header.levelCount > 32u || header.supercompressionScheme != 0u) {
+			Logger::log("Unsupported KTX2 texture ", path);
+			return {};
+		}
+		if (sizeof(Ktx2Header) + header.levelCount * sizeof(Ktx2Level) > file.size()) {
+			return {};
+		}
+
+		std::vector<Ktx2Level> entries(header.levelCount);
+		memcpy(entries.data(), file.data() + sizeof(Ktx2Header), entries.size() * sizeof(Ktx2Level));
+
+		uint64_t begin = file.size();
+		uint64_t end = 0;
+		auto alignment = levelAlignment(format);
+		for (uint32_t level = 0; level < header.levelCount; ++level) {
+			uint32_t width = std::max(header.pixelWidth >> level, 1u);
+			uint32_t height = std::max(header.pixelHeight >> level, 1u);
+			auto const& entry = entries[level];
+			if (entry.byteLength != levelSize(*block, width, height) || entry.byteOffset % alignment != 0u ||
+				entry.byteOffset + entry.byteLength > file.size()) {
+				Logger::log("KTX2 texture ", path, " has an invalid level ", level);
+				return {};
+			}
+			begin = std::min(begin, entry.byteOffset);
+			end = std::max(end, entry.byteOffset + entry.byteLength);
+		}
+
+		Texture texture;
+		texture.textureFormat = format;
+		for (uint32_t level = 0; level < header.levelCount; ++level) {
+			texture.textureLevels.push_back({
+				std::max(header.pixelWidth >> level, 1u),
+				std::max(header.pixelHeight >> level, 1u),
+				static_cast<size_t>(entries[level].byteOffset - begin),
+				static_cast<size_t>(entries[level].byteLength)
+			});
+		}
+		texture.dataPointer = reinterpret_cast<uint8_t const*>(file.data()) + begin;
+		texture.size = static_cast<size_t>(end - begin);
+		texture.file = std::move(file);
+		return texture;
+	}
+
+	void Texture::writeKtx2(std::string const& path) const {
+		auto block = formatBlock(textureFormat);
+		Logger::assertTrue(block.has_value(), "Texture format can not be written to KTX2");
+		auto descriptor = dataFormatDescriptor(textureFormat, *block);
+		auto alignment = levelAlignment(textureFormat);
+
+		Ktx2Header header{};
+		memcpy(header.identifier, identifier, sizeof(identifier));
+		header.vkFormat = static_cast<uint32_t>(textureFormat);
+		header.typeSize = 1u;
+		header.pixelWidth = width();
+		header.pixelHeight = height();
+		header.faceCount = 1u;
+		header.levelCount = levelCount();
+		header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + textureLevels.size() * sizeof(Ktx2Level));
+		header.dfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+
+		// Level data follows the descriptor smallest level first
+		std::vector<Ktx2Level> entries(textureLevels.size());
+		size_t offset = header.dfdByteOffset + header.dfdByteLength;
+		for (size_t level = textureLevels.size(); level-- > 0u;) {
+			offset = alignUp(offset, alignment);
+			entries[level] = {offset, textureLevels[level].size, textureLevels[level].size};
+			offset += textureLevels[level].size;
+		}
+
+		std::vector<Util::FileChunk> chunks{
+			{&header, sizeof(Ktx2Header)},
+			{entries.data(), entries.size() * sizeof(Ktx2Level)},
+			{descriptor.data(), descriptor.size() * sizeof(uint32_t)}
+		};
+		size_t position = header.dfdByteOffset + header.dfdByteLength;
+		char const padding[16] = {};
+		for (size_t level = textureLevels.size(); level-- > 0u;) {
+			chunks.push_back({padding, entries[level].byteOffset - position});
+			chunks.push_back({dataPointer + textureLevels[level].offset, textureLevels[level].size});
+			position = entries[level].byteOffset + entries[level].byteLength;
+		}
+		Util::writeFileAtomically(path, chunks);
+	}
+
+	vk::Format Texture::format() const {
+		return textureFormat;
+	}
+
+	uint32_t Texture::width() const {
+		return textureLevels.empty() ? 0u : textureLevels[0].width;
+	}
+
+	uint32_t Texture::height() const {
+		return textureLevels.empty() ? 0u : textureLevels[0].height;
+	}
+
+	uint32_t Texture::levelCount() const {
+		return static_cast<uint32_t>(textureLevels.size());
+	}
+
+	std::vector<TextureLevel> const& Texture::levels() const {
+		return textureLevels;
+	}
+
+	uint8_t const* Texture::data() const {
+		return dataPointer;
+	}
+
+	size_t Texture::dataSize() const {
+		return size;
+	}
+}
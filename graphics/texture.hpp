@@ -0,0 +1,70 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_TEXTURE_HPP
+#define VULKAN_ENGINE_TEXTURE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "../util/mapped-file.hpp"
+
+namespace Graphics {
+	struct TextureLevel {
+		uint32_t width;
+		uint32_t height;
+		// Relative to Texture::data()
+		size_t offset;
+		size_t size;
+	};
+
+	// Size of one texel block: 1x1 for uncompressed formats
+	struct FormatBlock {
+		uint32_t width;
+		uint32_t height;
+		uint32_t size;
+	};
+
+	// Returns {} for formats textures can not be stored in
+	std::optional<FormatBlock> formatBlock(vk::Format format);
+
+	/*
+	 * A 2D texture with its complete mip chain, ready to be copied into a staging buffer as one block.
+	 * Stored on disk as KTX2 (no supercompression, smallest level first), loaded textures stay memory-mapped.
+	 * Level offsets are aligned to the texel block size and 4 bytes, as vkCmdCopyBufferToImage requires.
+	 */
+	class Texture {
+	public:
+		Texture() = default;
+		// levels are ordered largest first and their offsets index into data
+		Texture(vk::Format format, std::vector<TextureLevel> levels, std::vector<uint8_t> data);
+
+		// Returns {} when the file is missing or not a KTX2 texture this loader understands
+		static std::optional<Texture> loadKtx2(std::string const& path);
+		void writeKtx2(std::string const& path) const;
+
+		vk::Format format() const;
+		uint32_t width() const;
+		uint32_t height() const;
+		uint32_t levelCount() const;
+		std::vector<TextureLevel> const& levels() const;
+		uint8_t const* data() const;
+		size_t dataSize() const;
+
+		// Alignment of level offsets for a format, lcm(block size, 4)
+		static size_t levelAlignment(vk::Format format);
+	private:
+		vk::Format textureFormat = vk::Format::eUndefined;
+		std::vector<TextureLevel> textureLevels;
+		std::vector<uint8_t> ownedData;
+		Util::MappedFile file;
+		uint8_t const* dataPointer = nullptr;
+		size_t size = 0;
+	};
+}
+
+#endif //VULKAN_ENGINE_TEXTURE_HPP
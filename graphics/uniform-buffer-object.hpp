@@ -8,10 +8,13 @@
 #include <glm/glm.hpp>
 
 namespace Graphics {
+	// Per-frame data, per-draw transforms are pushed as DrawConstants
 	struct UniformBufferObject {
-		alignas(16) glm::mat4 model;
 		alignas(16) glm::mat4 view;
 		alignas(16) glm::mat4 projection;
+		// Dequantization of packed vertex positions, xyz used
+		alignas(16) glm::vec4 positionScale;
+		alignas(16) glm::vec4 positionOffset;
 	};
 }
 
@@ -0,0 +1,207 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <cstring>
+
+#include "upload-context.hpp"
+#include "../logger/logger.hpp"
+
+namespace Graphics {
+	UploadContext::UploadContext(Device& device, vma::Allocator allocator, FrameTimeline& timeline)
+		: device(device), allocator(allocator), timeline(timeline),
+		  dedicatedTransfer(device.hasDedicatedTransferQueue()) {
+		graphicsPool = device.createCommandPool({
+			vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient,
+			device.graphicsIndex()
+		});
+		if (dedicatedTransfer) {
+			transferPool = device.createCommandPool({
+				vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient,
+				device.transferIndex()
+			});
+		}
+	}
+
+	UploadContext::Batch& UploadContext::batch() {
+		if (recording) {
+			return *recording;
+		}
+
+		if (recycled.empty()) {
+			Batch created;
+			created.graphicsCommands = device.allocateCommandBuffers({
+				graphicsPool, vk::CommandBufferLevel::ePrimary, 1u
+			})[0];
+			created.transferCommands = created.graphicsCommands;
+			if (dedicatedTransfer) {
+				created.transferCommands = device.allocateCommandBuffers({
+					transferPool, vk::CommandBufferLevel::ePrimary, 1u
+				})[0];
+				created.transferFinished = device.createSemaphore({});
+			}
+			recording = std::move(created);
+		} else {
+			recording = std::move(recycled.back());
+			recycled.pop_back();
+			recording->graphicsCommands.reset({});
+			if (dedicatedTransfer) {
+				recording->transferCommands.reset({});
+			}
+		}
+
+		// The transfer command buffer is only begun by the first upload, see stage
+		recording->graphicsCommands.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+		return *recording;
+	}
+
+	vk::Buffer UploadContext::stage(Batch& batch, void const* data, vk::DeviceSize size) {
+		Buffer stagingBuffer(allocator, size, vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			vma::MemoryUsage::eCpuToGpu);
+		auto mappedMemory = allocator.mapMemory(stagingBuffer);
+		memcpy(mappedMemory, data, static_cast<size_t>(size));
+		allocator.unmapMemory(stagingBuffer);
+
+		// Batches without uploads never submit to the transfer queue, their graphics point alone says when the
+		// transfer command buffer may be reset again
+		if (dedicatedTransfer && !batch.hasTransfers) {
+			batch.transferCommands.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+		}
+		batch.stagingBuffers.push_back(stagingBuffer);
+		batch.stagedBytes += size;
+		batch.hasTransfers = true;
+		return stagingBuffer;
+	}
+
+	void UploadContext::uploadBuffer(void const* data, vk::DeviceSize size, vk::Buffer destination,
+									 vk::AccessFlags dstAccess, vk::PipelineStageFlags dstStage) {
+		auto& current = batch();
+		auto source = stage(current, data, size);
+		vk::BufferCopy copyRegion{0, 0, size};
+		current.transferCommands.copyBuffer(source, destination, 1u, &copyRegion);
+
+		// Ownership moves from the transfer to the graphics family: a release here, the matching acquire there
+		vk::BufferMemoryBarrier barrier{
+			vk::AccessFlagBits::eTransferWrite, dstAccess,
+			VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+			destination, 0u, VK_WHOLE_SIZE
+		};
+		if (!dedicatedTransfer) {
+			current.graphicsCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, dstStage, {},
+				0u, nullptr, 1u, &barrier, 0u, nullptr);
+			return;
+		}
+		barrier.srcQueueFamilyIndex = device.transferIndex();
+		barrier.dstQueueFamilyIndex = device.graphicsIndex();
+		barrier.dstAccessMask = {};
+		current.transferCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eBottomOfPipe, {}, 0u, nullptr, 1u, &barrier, 0u, nullptr);
+		barrier.srcAccessMask = {};
+		barrier.dstAccessMask = dstAccess;
+		current.graphicsCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, dstStage, {},
+			0u, nullptr, 1u, &barrier, 0u, nullptr);
+	}
+
+	void UploadContext::uploadImage(void const* data, vk::DeviceSize size, vk::Image image, uint32_t mipLevels,
+									std::vector<vk::BufferImageCopy> const& regions) {
+		auto& current = batch();
+		auto source = stage(current, data, size);
+
+		vk::ImageMemoryBarrier barrier{
+			{}, vk::AccessFlagBits::eTransferWrite,
+			vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+			VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+			image,
+			{vk::ImageAspectFlagBits::eColor, 0u, mipLevels, 0u, 1u}
+		};
+		current.transferCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+			vk::PipelineStageFlagBits::eTransfer, {}, 0u, nullptr, 0u, nullptr, 1u, &barrier);
+		current.transferCommands.copyBufferToImage(source, image, vk::ImageLayout::eTransferDstOptimal,
+			static_cast<uint32_t>(regions.size()), regions.data());
+
+		// Release and acquire have to name the same layout transition
+		barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+		barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+		barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		if (!dedicatedTransfer) {
+			current.graphicsCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eFragmentShader, {}, 0u, nullptr, 0u, nullptr, 1u, &barrier);
+			return;
+		}
+		barrier.srcQueueFamilyIndex = device.transferIndex();
+		barrier.dstQueueFamilyIndex = device.graphicsIndex();
+		barrier.dstAccessMask = {};
+		current.transferCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eBottomOfPipe, {}, 0u, nullptr, 0u, nullptr, 1u, &barrier);
+		barrier.srcAccessMask = {};
+		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+		current.graphicsCommands.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+			vk::PipelineStageFlagBits::eFragmentShader, {}, 0u, nullptr, 0u, nullptr, 1u, &barrier);
+	}
+
+	void UploadContext::record(std::function<void(vk::CommandBuffer)> const& callback) {
+		callback(batch().graphicsCommands);
+	}
+
+	void UploadContext::flush() {
+		if (!recording) {
+			return;
+		}
+
+		auto current = std::move(*recording);
+		recording.reset();
+		current.graphicsCommands.end();
+
+		// Only batches with uploads go through the transfer queue, the graphics submission then waits for them
+		bool waitForTransfer = dedicatedTransfer && current.hasTransfers;
+		if (waitForTransfer) {
+			current.transferCommands.end();
+			vk::SubmitInfo transferSubmit{
+				0u, nullptr, nullptr, 1u, &current.transferCommands,
+				1u, &current.transferFinished
+			};
+			device.transferQueue.submit(1u, &transferSubmit, vk::Fence{});
+		}
+
+		vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+		vk::SubmitInfo graphicsSubmit{
+			waitForTransfer ? 1u : 0u, &current.transferFinished, &waitStage, 1u, &current.graphicsCommands
+		};
+		current.point = timeline.submit(graphicsSubmit);
+
+		if (current.stagedBytes > 0u) {
+			Logger::log("Submitted ", current.stagingBuffers.size(), " uploads (", current.stagedBytes,
+				" bytes) in one batch");
+		}
+		// Staging buffers outlive the batch until its point completes
+		timeline.release([allocator = allocator, stagingBuffers = std::move(current.stagingBuffers)]() mutable {
+			for (auto& stagingBuffer : stagingBuffers) {
+				allocator.destroyBuffer(stagingBuffer, stagingBuffer);
+			}
+		});
+		current.stagingBuffers.clear();
+		current.stagedBytes = 0u;
+		current.hasTransfers = false;
+		submitted.push_back(std::move(current));
+	}
+
+	void UploadContext::collect() {
+		for (auto batch = submitted.begin(); batch != submitted.end();) {
+			if (!timeline.isComplete(batch->point)) {
+				++batch;
+				continue;
+			}
+			recycled.push_back(std::move(*batch));
+			batch = submitted.erase(batch);
+		}
+	}
+
+	void UploadContext::wait() {
+		if (!submitted.empty()) {
+			timeline.wait(submitted.back().point);
+		}
+		collect();
+	}
+}
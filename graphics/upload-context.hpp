@@ -0,0 +1,75 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_UPLOAD_CONTEXT_HPP
+#define VULKAN_ENGINE_UPLOAD_CONTEXT_HPP
+
+#include <functional>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include <vma.hpp>
+
+#include "buffer.hpp"
+#include "device.hpp"
+#include "frame-timeline.hpp"
+
+namespace Graphics {
+	/*
+	 * Records any number of uploads and graphics queue commands into one batch that flush() submits at once.
+	 * Each batch is a point on the frame timeline. Its staging buffers are released through the timeline once it
+	 * completes, and command buffers and semaphores of completed batches are recycled for later ones.
+	 * With a dedicated transfer queue, copies run there and release the resources to the graphics queue family,
+	 * whose submission acquires them after waiting for the transfer submission. Otherwise the whole batch is a
+	 * single graphics queue submission.
+	 */
+	class UploadContext {
+	public:
+		UploadContext(Device& device, vma::Allocator allocator, FrameTimeline& timeline);
+		UploadContext(UploadContext const&) = delete;
+		UploadContext& operator=(UploadContext const&) = delete;
+
+		// Copies data into destination, which becomes readable with dstAccess in dstStage on the graphics queue
+		void uploadBuffer(void const* data, vk::DeviceSize size, vk::Buffer destination, vk::AccessFlags dstAccess,
+						  vk::PipelineStageFlags dstStage);
+		// Copies all regions (offsets relative to data) and leaves every level ready for fragment shader reads
+		void uploadImage(void const* data, vk::DeviceSize size, vk::Image image, uint32_t mipLevels,
+						 std::vector<vk::BufferImageCopy> const& regions);
+		// Records graphics queue commands, ordered after the uploads recorded before them
+		void record(std::function<void(vk::CommandBuffer)> const& callback);
+
+		// Submits the batch recorded since the last flush without waiting for it
+		void flush();
+		// Recycles batches whose timeline point completed, never blocks
+		void collect();
+		// Blocks until every submitted batch completed, then collects them
+		void wait();
+	private:
+		struct Batch {
+			// Same command buffer as graphicsCommands without a dedicated transfer queue
+			vk::CommandBuffer transferCommands;
+			vk::CommandBuffer graphicsCommands;
+			vk::Semaphore transferFinished;
+			uint64_t point = 0;
+			std::vector<Buffer> stagingBuffers;
+			vk::DeviceSize stagedBytes = 0;
+			bool hasTransfers = false;
+		};
+
+		Device& device;
+		vma::Allocator allocator;
+		FrameTimeline& timeline;
+		bool dedicatedTransfer;
+		vk::CommandPool graphicsPool;
+		vk::CommandPool transferPool;
+		std::optional<Batch> recording;
+		std::vector<Batch> submitted;
+		std::vector<Batch> recycled;
+
+		Batch& batch();
+		vk::Buffer stage(Batch& batch, void const* data, vk::DeviceSize size);
+	};
+}
+
+#endif //VULKAN_ENGINE_UPLOAD_CONTEXT_HPP
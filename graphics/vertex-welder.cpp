@@ -0,0 +1,101 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <cmath>
+#include <cstring>
+
+#include "vertex-welder.hpp"
+#include "../util/hash.hpp"
+
+namespace Graphics {
+	namespace {
+		uint32_t snap(float value, float epsilon) {
+			if (epsilon <= 0.0f) {
+				// Adding zero turns -0.0f into 0.0f, which compare equal and must hash equal
+				value += 0.0f;
+				uint32_t bits;
+				memcpy(&bits, &value, sizeof(bits));
+				return bits;
+			}
+			return static_cast<uint32_t>(static_cast<int32_t>(std::floor(value / epsilon + 0.5f)));
+		}
+	}
+
+	VertexWelder::VertexWelder(size_t expectedVertices, float positionEpsilon, float attributeEpsilon)
+		: positionEpsilon(positionEpsilon), attributeEpsilon(attributeEpsilon) {
+		size_t capacity = 64u;
+		while (capacity < expectedVertices * 2u) {
+			capacity *= 2u;
+		}
+		slots.assign(capacity, empty);
+		mask = capacity - 1u;
+		weldedVertices.reserve(expectedVertices);
+		hashes.reserve(expectedVertices);
+	}
+
+	VertexWelder::Key VertexWelder::makeKey(Vertex const& vertex) const {
+		return Key{
+			snap(vertex.position.x, positionEpsilon),
+			snap(vertex.position.y, positionEpsilon),
+			snap(vertex.position.z, positionEpsilon),
+			snap(vertex.color.x, attributeEpsilon),
+			snap(vertex.color.y, attributeEpsilon),
+			snap(vertex.color.z, attributeEpsilon),
+			snap(vertex.texCoord.x, attributeEpsilon),
+			snap(vertex.texCoord.y, attributeEpsilon)
+		};
+	}
+
+	uint64_t VertexWelder::hash(Vertex const& vertex) const {
+		auto key = makeKey(vertex);
+		return Util::hash64(key.data(), sizeof(key));
+	}
+
+	uint32_t VertexWelder::weld(Vertex const& vertex) {
+		return weld(vertex, hash(vertex));
+	}
+
+	uint32_t VertexWelder::weld(Vertex const& vertex, uint64_t hash) {
+		auto key = makeKey(vertex);
+		size_t slot = hash & mask;
+		while (slots[slot] != empty) {
+			uint32_t index = slots[slot];
+			if (hashes[index] == hash && makeKey(weldedVertices[index]) == key) {
+				return index;
+			}
+			slot = (slot + 1u) & mask;
+		}
+
+		auto index = static_cast<uint32_t>(weldedVertices.size());
+		slots[slot] = index;
+		weldedVertices.push_back(vertex);
+		hashes.push_back(hash);
+		if (weldedVertices.size() * 2u > slots.size()) {
+			grow();
+		}
+		return index;
+	}
+
+	void VertexWelder::grow() {
+		slots.assign(slots.size() * 2u, empty);
+		mask = slots.size() - 1u;
+		for (uint32_t index = 0; index < static_cast<uint32_t>(hashes.size()); ++index) {
+			size_t slot = hashes[index] & mask;
+			while (slots[slot] != empty) {
+				slot = (slot + 1u) & mask;
+			}
+			slots[slot] = index;
+		}
+	}
+
+	std::vector<Vertex> const& VertexWelder::vertices() const {
+		return weldedVertices;
+	}
+
+	std::vector<Vertex> VertexWelder::takeVertices() {
+		slots = {};
+		hashes = {};
+		return std::move(weldedVertices);
+	}
+}
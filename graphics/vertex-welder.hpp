@@ -0,0 +1,49 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_VERTEX_WELDER_HPP
+#define VULKAN_ENGINE_VERTEX_WELDER_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "vertex.hpp"
+
+namespace Graphics {
+	/*
+	 * Deduplicates vertices into a contiguous array through a flat open-addressing table of vertex indices,
+	 * keyed by a 64-bit hash of the vertex bytes. With nonzero epsilons, attributes are snapped to a grid of
+	 * that size before hashing and comparing, so vertices that land in the same cell are welded together and
+	 * the first one inserted is kept.
+	 */
+	class VertexWelder {
+	public:
+		explicit VertexWelder(size_t expectedVertices = 0u, float positionEpsilon = 0.0f,
+							  float attributeEpsilon = 0.0f);
+
+		// Returns the index of the vertex in vertices(), appending it if no equal vertex was welded before
+		uint32_t weld(Vertex const& vertex);
+		uint32_t weld(Vertex const& vertex, uint64_t hash);
+		uint64_t hash(Vertex const& vertex) const;
+
+		std::vector<Vertex> const& vertices() const;
+		std::vector<Vertex> takeVertices();
+	private:
+		using Key = std::array<uint32_t, sizeof(Vertex) / sizeof(float)>;
+		static constexpr uint32_t empty = UINT32_MAX;
+
+		float positionEpsilon;
+		float attributeEpsilon;
+		std::vector<Vertex> weldedVertices;
+		std::vector<uint64_t> hashes;
+		std::vector<uint32_t> slots;
+		size_t mask = 0;
+
+		Key makeKey(Vertex const& vertex) const;
+		void grow();
+	};
+}
+
+#endif //VULKAN_ENGINE_VERTEX_WELDER_HPP
@@ -2,23 +2,66 @@
 // Created by sabrina on 10/31/19.
 //
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "vertex.hpp"
 
 namespace Graphics {
+	namespace {
+		// Round to nearest even float to IEEE half conversion
+		uint16_t floatToHalf(float value) {
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			auto sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+			uint32_t floatExponent = (bits >> 23u) & 0xffu;
+			uint32_t mantissa = bits & 0x7fffffu;
+
+			if (floatExponent == 0xffu) {
+				return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+			}
+
+			int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+			if (exponent >= 31) {
+				return static_cast<uint16_t>(sign | 0x7c00u);
+			}
+
+			if (exponent <= 0) {
+				if (exponent < -10) {
+					return sign;
+				}
+				mantissa |= 0x800000u;
+				auto shift = static_cast<uint32_t>(14 - exponent);
+				uint32_t half = mantissa >> shift;
+				uint32_t remainder = mantissa & ((1u << shift) - 1u);
+				uint32_t halfway = 1u << (shift - 1u);
+				if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+					++half;
+				}
+				return static_cast<uint16_t>(sign | half);
+			}
+
+			uint32_t half = (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+			uint32_t remainder = mantissa & 0x1fffu;
+			if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+				++half; // A carry into the exponent is still the correctly rounded result
+			}
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		uint16_t quantizeUnorm16(float value, float offset, float scale) {
+			float normalized = scale > 0.0f ? (value - offset) / scale : 0.0f;
+			return static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+		}
+	}
+
 	vk::VertexInputBindingDescription Vertex::getBindingDescription() {
-		return vk::VertexInputBindingDescription{
-			0,
-			sizeof(Vertex),
-			vk::VertexInputRate::eVertex
-		};
+		return bindingDescriptionFor<Vertex>();
 	}
 
 	std::array<vk::VertexInputAttributeDescription, 3> Vertex::getAttributeDescriptions() {
-		return std::array<vk::VertexInputAttributeDescription, 3>{{
-			{0u, 0u, vk::Format::eR32G32B32Sfloat, 0u},
-			{1u, 0u, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color)},
-			{2u, 0u, vk::Format::eR32G32Sfloat, offsetof(Vertex, texCoord)}
-		}};
+		return attributeDescriptionsFor<Vertex>();
 	}
 
 	Vertex::Vertex(glm::vec3 position, glm::vec3 color, glm::vec2 texCoord): position(position), color(color),
@@ -27,4 +70,66 @@ namespace Graphics {
 	bool Vertex::operator==(const Vertex& other) const {
 		return position == other.position && color == other.color && texCoord == other.texCoord;
 	}
+
+	PackedVertex PackedVertex::pack(Vertex const& vertex, Dequantization const& dequantization) {
+		return PackedVertex{
+			{
+				quantizeUnorm16(vertex.position.x, dequantization.offset.x, dequantization.scale.x),
+				quantizeUnorm16(vertex.position.y, dequantization.offset.y, dequantization.scale.y),
+				quantizeUnorm16(vertex.position.z, dequantization.offset.z, dequantization.scale.z),
+				0u
+			},
+			{
+				floatToHalf(vertex.texCoord.x),
+				floatToHalf(vertex.texCoord.y)
+			}
+		};
+	}
+
+	Dequantization PackedVertex::dequantizationFor(std::vector<Vertex> const& vertices) {
+		if (vertices.empty()) {
+			return {glm::vec3{1.0f, 1.0f, 1.0f}, glm::vec3{0.0f, 0.0f, 0.0f}};
+		}
+
+		glm::vec3 minimum = vertices[0].position;
+		glm::vec3 maximum = vertices[0].position;
+		for (auto const& vertex : vertices) {
+			minimum = glm::min(minimum, vertex.position);
+			maximum = glm::max(maximum, vertex.position);
+		}
+		return {maximum - minimum, minimum};
+	}
+
+	vk::VertexInputBindingDescription PackedVertex::getBindingDescription() {
+		return bindingDescriptionFor<PackedVertex>();
+	}
+
+	std::array<vk::VertexInputAttributeDescription, 2> PackedVertex::getAttributeDescriptions() {
+		return attributeDescriptionsFor<PackedVertex>();
+	}
+
+	namespace {
+		template <typename VertexType>
+		VertexInputDescription describe() {
+			auto attributes = attributeDescriptionsFor<VertexType>();
+			return {
+				bindingDescriptionFor<VertexType>(),
+				std::vector<vk::VertexInputAttributeDescription>(attributes.begin(), attributes.end())
+			};
+		}
+	}
+
+	VertexInputDescription describeVertexInput(VertexFormat format) {
+		switch (format) {
+			case VertexFormat::ePacked:
+				return describe<PackedVertex>();
+			case VertexFormat::eStandard:
+			default:
+				return describe<Vertex>();
+		}
+	}
+
+	uint32_t vertexStride(VertexFormat format) {
+		return format == VertexFormat::ePacked ? sizeof(PackedVertex) : sizeof(Vertex);
+	}
 }
@@ -5,12 +5,19 @@
 #ifndef VULKAN_ENGINE_VERTEX_HPP
 #define VULKAN_ENGINE_VERTEX_HPP
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.hpp>
 
 namespace Graphics {
+	enum class VertexFormat : uint32_t {
+		eStandard,
+		ePacked
+	};
+
 	struct Vertex {
 		glm::vec3 position;
 		glm::vec3 color;
@@ -24,16 +31,85 @@ namespace Graphics {
 
 		bool operator==(const Vertex& other) const;
 	};
-}
 
-namespace std {
-	template<> struct hash<Graphics::Vertex> {
-		size_t operator()(Graphics::Vertex const& vertex) const {
-			return ((hash<glm::vec3>()(vertex.position) ^ //NOLINT
-				(hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^ //NOLINT
-				(hash<glm::vec2>()(vertex.texCoord) << 1); //NOLINT
+	// Maps quantized positions in [0, 1] back to model space: position * scale + offset
+	struct Dequantization {
+		glm::vec3 scale;
+		glm::vec3 offset;
+	};
+
+	/*
+	 * 12 byte vertex: position as 16-bit unorm relative to the mesh bounds (w is padding), texture
+	 * coordinates as half floats and no color stream, since loaded models always use white.
+	 */
+	struct PackedVertex {
+		uint16_t position[4];
+		uint16_t texCoord[2];
+
+		static PackedVertex pack(Vertex const& vertex, Dequantization const& dequantization);
+		static Dequantization dequantizationFor(std::vector<Vertex> const& vertices);
+
+		static vk::VertexInputBindingDescription getBindingDescription();
+
+		static std::array<vk::VertexInputAttributeDescription, 2> getAttributeDescriptions();
+	};
+
+	struct VertexAttribute {
+		uint32_t location;
+		vk::Format format;
+		uint32_t offset;
+	};
+
+	// Compile time description of a vertex type, shader locations match graphics/shaders/*.vert
+	template <typename VertexType>
+	struct VertexLayout;
+
+	template <>
+	struct VertexLayout<Vertex> {
+		static constexpr VertexFormat format = VertexFormat::eStandard;
+		static constexpr std::array<VertexAttribute, 3> attributes{{
+			{0u, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)},
+			{1u, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color)},
+			{2u, vk::Format::eR32G32Sfloat, offsetof(Vertex, texCoord)}
+		}};
+	};
+
+	template <>
+	struct VertexLayout<PackedVertex> {
+		static constexpr VertexFormat format = VertexFormat::ePacked;
+		static constexpr std::array<VertexAttribute, 2> attributes{{
+			{0u, vk::Format::eR16G16B16A16Unorm, offsetof(PackedVertex, position)},
+			{2u, vk::Format::eR16G16Sfloat, offsetof(PackedVertex, texCoord)}
+		}};
+	};
+
+	template <typename VertexType>
+	vk::VertexInputBindingDescription bindingDescriptionFor() {
+		return vk::VertexInputBindingDescription{
+			0u,
+			sizeof(VertexType),
+			vk::VertexInputRate::eVertex
+		};
+	}
+
+	template <typename VertexType>
+	std::array<vk::VertexInputAttributeDescription, VertexLayout<VertexType>::attributes.size()> attributeDescriptionsFor() {
+		std::array<vk::VertexInputAttributeDescription, VertexLayout<VertexType>::attributes.size()> descriptions{};
+		for (size_t i = 0; i < descriptions.size(); ++i) {
+			auto const& attribute = VertexLayout<VertexType>::attributes[i];
+			descriptions[i] = vk::VertexInputAttributeDescription{attribute.location, 0u, attribute.format, attribute.offset};
 		}
+		return descriptions;
+	}
+
+	struct VertexInputDescription {
+		vk::VertexInputBindingDescription binding;
+		std::vector<vk::VertexInputAttributeDescription> attributes;
 	};
+
+	// Runtime dispatch for meshes whose format is only known after loading
+	VertexInputDescription describeVertexInput(VertexFormat format);
+	uint32_t vertexStride(VertexFormat format);
 }
 
 #endif //VULKAN_ENGINE_VERTEX_HPP
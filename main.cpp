@@ -2,12 +2,70 @@
 #define ENABLE_VK_VALIDATION
 #endif
 
-#include <iostream>
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
 #include "graphics/renderer.hpp"
+#include "graphics/texture-cooker.hpp"
+#include "logger/logger.hpp"
+
+int main(int argc, char** argv) {
+    Graphics::RendererSettings settings{};
+    std::optional<std::pair<std::string, std::string>> cookPaths;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--headless") {
+            settings.headless = true;
+        } else if (argument == "--frames" && i + 1 < argc) {
+            settings.frameLimit = std::stoull(argv[++i]);
+        } else if (argument == "--standard-vertices") {
+            settings.mesh.vertexFormat = Graphics::VertexFormat::eStandard;
+        } else if (argument == "--no-meshlets") {
+            settings.mesh.meshlets = false;
+        } else if (argument == "--lods" && i + 1 < argc) {
+            settings.mesh.lodCount = static_cast<uint32_t>(std::max(std::stoi(argv[++i]), 1));
+        } else if (argument == "--objects" && i + 1 < argc) {
+            settings.objectCount = static_cast<uint32_t>(std::max(std::stoi(argv[++i]), 0));
+        } else if (argument == "--recording-threads" && i + 1 < argc) {
+            settings.recordingThreads = static_cast<uint32_t>(std::max(std::stoi(argv[++i]), 1));
+        } else if (argument == "--mix-vertex-color") {
+            settings.fragmentVariant.set(Graphics::FragmentConstant::eMixVertexColor, VK_TRUE);
+        } else if (argument == "--blur-radius" && i + 1 < argc) {
+            settings.fragmentVariant.set(Graphics::FragmentConstant::eBlurRadius,
+                static_cast<uint32_t>(std::max(std::stoi(argv[++i]), 0)));
+        } else if (argument == "--watch-shaders" && i + 1 < argc) {
+            settings.shaderSourceDirectory = argv[++i];
+        } else if (argument == "--texture-format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format == "rgba8") {
+                settings.textureFormat = vk::Format::eR8G8B8A8Unorm;
+            } else if (format == "bc1") {
+                settings.textureFormat = vk::Format::eBc1RgbUnormBlock;
+            } else if (format == "bc3") {
+                settings.textureFormat = vk::Format::eBc3UnormBlock;
+            } else if (format == "bc7") {
+                settings.textureFormat = vk::Format::eBc7UnormBlock;
+            } else {
+                Logger::log("Unknown texture format ", format, ", expected rgba8, bc1, bc3 or bc7");
+                return 1;
+            }
+        } else if (argument == "--cook-texture" && i + 2 < argc) {
+            cookPaths.emplace(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+    }
+
+    // Offline cooking: write the mip chain of an image to a KTX2 file and exit. Runs after parsing so the
+    // texture format applies wherever it appears on the command line
+    if (cookPaths) {
+        Util::ThreadPool threadPool;
+        Graphics::cookTexture(cookPaths->first, settings.textureFormat, threadPool).writeKtx2(cookPaths->second);
+        return 0;
+    }
 
-int main() {
     Core::Game game{ "Michael's Toys", 0, 1, 0};
-    Graphics::Renderer renderer(game);
+    Graphics::Renderer renderer(game, settings);
     renderer.start();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,29 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <filesystem>
+#include <fstream>
+
+#include "atomic-file.hpp"
+#include "../logger/logger.hpp"
+
+namespace Util {
+	void writeFileAtomically(std::string const& path, std::vector<FileChunk> const& chunks) {
+		auto parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty()) {
+			std::filesystem::create_directories(parent);
+		}
+
+		auto temporaryPath = path + ".tmp";
+		{
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			Logger::assertTrue(stream.is_open(), "Failed to write " + temporaryPath);
+			for (auto const& chunk : chunks) {
+				stream.write(static_cast<char const*>(chunk.data), static_cast<std::streamsize>(chunk.size));
+			}
+			Logger::assertTrue(stream.good(), "Failed to write " + temporaryPath);
+		}
+		std::filesystem::rename(temporaryPath, path);
+	}
+}
@@ -0,0 +1,26 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_ATOMIC_FILE_HPP
+#define VULKAN_ENGINE_ATOMIC_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Util {
+	// One contiguous piece of a file, written back to back with the others
+	struct FileChunk {
+		void const* data;
+		size_t size;
+	};
+
+	/*
+	 * Writes the chunks to a temporary file next to path and renames it over path, so readers and crashes only ever
+	 * see the old or the complete new file. Missing parent directories are created, failures throw.
+	 */
+	void writeFileAtomically(std::string const& path, std::vector<FileChunk> const& chunks);
+}
+
+#endif //VULKAN_ENGINE_ATOMIC_FILE_HPP
@@ -0,0 +1,99 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <cstring>
+#include "hash.hpp"
+
+namespace Util {
+	namespace {
+		uint64_t const prime1 = 11400714785074694791ull;
+		uint64_t const prime2 = 14029467366897019727ull;
+		uint64_t const prime3 = 1609587929392839161ull;
+		uint64_t const prime4 = 9650029242287828579ull;
+		uint64_t const prime5 = 2870177450012600261ull;
+
+		inline uint64_t rotateLeft(uint64_t value, int bits) {
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		inline uint64_t read64(unsigned char const* bytes) {
+			uint64_t value;
+			memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		inline uint32_t read32(unsigned char const* bytes) {
+			uint32_t value;
+			memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		inline uint64_t round(uint64_t accumulator, uint64_t input) {
+			accumulator += input * prime2;
+			accumulator = rotateLeft(accumulator, 31);
+			return accumulator * prime1;
+		}
+
+		inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+			accumulator ^= round(0u, value);
+			return accumulator * prime1 + prime4;
+		}
+	}
+
+	uint64_t hash64(void const* data, size_t size, uint64_t seed) {
+		auto bytes = static_cast<unsigned char const*>(data);
+		auto end = bytes + size;
+		uint64_t hash;
+
+		if (size >= 32u) {
+			auto limit = end - 32;
+			uint64_t v1 = seed + prime1 + prime2;
+			uint64_t v2 = seed + prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime1;
+			do {
+				v1 = round(v1, read64(bytes));
+				v2 = round(v2, read64(bytes + 8));
+				v3 = round(v3, read64(bytes + 16));
+				v4 = round(v4, read64(bytes + 24));
+				bytes += 32;
+			} while (bytes <= limit);
+
+			hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+			hash = mergeRound(hash, v1);
+			hash = mergeRound(hash, v2);
+			hash = mergeRound(hash, v3);
+			hash = mergeRound(hash, v4);
+		} else {
+			hash = seed + prime5;
+		}
+
+		hash += static_cast<uint64_t>(size);
+
+		while (bytes + 8 <= end) {
+			hash ^= round(0u, read64(bytes));
+			hash = rotateLeft(hash, 27) * prime1 + prime4;
+			bytes += 8;
+		}
+
+		if (bytes + 4 <= end) {
+			hash ^= static_cast<uint64_t>(read32(bytes)) * prime1;
+			hash = rotateLeft(hash, 23) * prime2 + prime3;
+			bytes += 4;
+		}
+
+		while (bytes < end) {
+			hash ^= static_cast<uint64_t>(*bytes) * prime5;
+			hash = rotateLeft(hash, 11) * prime1;
+			++bytes;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
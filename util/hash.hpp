@@ -0,0 +1,19 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_HASH_HPP
+#define VULKAN_ENGINE_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util {
+	/*
+	 * 64-bit hash of raw bytes (xxHash64 algorithm). Strong enough for hash tables over
+	 * grid-aligned data and for content-based cache invalidation.
+	 */
+	uint64_t hash64(void const* data, size_t size, uint64_t seed = 0u);
+}
+
+#endif //VULKAN_ENGINE_HASH_HPP
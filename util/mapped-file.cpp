@@ -0,0 +1,71 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "mapped-file.hpp"
+#include "../logger/logger.hpp"
+
+namespace Util {
+	MappedFile::MappedFile(std::string const& filename) {
+		int descriptor = open(filename.c_str(), O_RDONLY);
+		if (descriptor < 0) {
+			throw Logger::error("failed to open file " + filename);
+		}
+
+		struct stat status{};
+		if (fstat(descriptor, &status) != 0) {
+			close(descriptor);
+			throw Logger::error("failed to stat file " + filename);
+		}
+
+		length = static_cast<size_t>(status.st_size);
+		if (length > 0) {
+			mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		}
+		close(descriptor);
+
+		if (mapping == MAP_FAILED) {
+			mapping = nullptr;
+			length = 0;
+			throw Logger::error("failed to map file " + filename);
+		}
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)) {}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			mapping = std::exchange(other.mapping, nullptr);
+			length = std::exchange(other.length, 0);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		unmap();
+	}
+
+	char const* MappedFile::data() const {
+		return static_cast<char const*>(mapping);
+	}
+
+	size_t MappedFile::size() const {
+		return length;
+	}
+
+	void MappedFile::unmap() {
+		if (mapping) {
+			munmap(mapping, length);
+		}
+		mapping = nullptr;
+		length = 0;
+	}
+}
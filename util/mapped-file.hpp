@@ -0,0 +1,35 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_MAPPED_FILE_HPP
+#define VULKAN_ENGINE_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace Util {
+	/*
+	 * Read-only memory mapping of a whole file. The mapping is released when the
+	 * MappedFile is destroyed, so it is move-only.
+	 */
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		explicit MappedFile(std::string const& filename);
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+		~MappedFile();
+
+		char const* data() const;
+		size_t size() const;
+		void unmap();
+	private:
+		void* mapping = nullptr;
+		size_t length = 0;
+	};
+}
+
+#endif //VULKAN_ENGINE_MAPPED_FILE_HPP
@@ -0,0 +1,66 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#include <algorithm>
+
+#include "thread-pool.hpp"
+
+namespace Util {
+	ThreadPool::ThreadPool(size_t threadCount) {
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i) {
+			workers.emplace_back([this]() { work(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void ThreadPool::work() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				if (stopping && tasks.empty()) {
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+			task();
+		}
+	}
+
+	void ThreadPool::parallelFor(size_t count, std::function<void(size_t)> const& body) {
+		std::vector<std::future<void>> futures;
+		futures.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			futures.push_back(submit([&body, i]() { body(i); }));
+		}
+		// get() rethrows the first exception thrown by a task, after every task has stopped using body
+		for (auto& future : futures) {
+			future.wait();
+		}
+		for (auto& future : futures) {
+			future.get();
+		}
+	}
+
+	size_t ThreadPool::size() const {
+		return workers.size();
+	}
+
+	size_t ThreadPool::defaultThreadCount() {
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+}
@@ -0,0 +1,54 @@
+//
+// Created by sabrina on 10/17/26.
+//
+
+#ifndef VULKAN_ENGINE_THREAD_POOL_HPP
+#define VULKAN_ENGINE_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Util {
+	class ThreadPool {
+	public:
+		explicit ThreadPool(size_t threadCount = defaultThreadCount());
+		~ThreadPool();
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+
+		template <typename Task>
+		auto submit(Task&& task) -> std::future<decltype(task())> {
+			using Result = decltype(task());
+			auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+			auto future = packagedTask->get_future();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.emplace([packagedTask]() { (*packagedTask)(); });
+			}
+			condition.notify_one();
+			return future;
+		}
+
+		// Runs body(i) for every i in [0, count) on the workers and blocks until all of them finished
+		void parallelFor(size_t count, std::function<void(size_t)> const& body);
+
+		size_t size() const;
+		static size_t defaultThreadCount();
+	private:
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+
+		void work();
+	};
+}
+
+#endif //VULKAN_ENGINE_THREAD_POOL_HPP